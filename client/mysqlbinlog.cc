@@ -114,6 +114,7 @@ static my_bool force_if_open_opt= 1;
 static my_bool opt_raw_mode= 0, opt_stop_never= 0;
 static ulong opt_stop_never_slave_server_id= 0;
 static my_bool opt_verify_binlog_checksum= 1;
+static uint opt_decode_threads= 0;
 static ulonglong offset = 0;
 static char* host = 0;
 static int port= 0;
@@ -1021,29 +1022,30 @@ static bool print_row_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
   @retval OK_STOP No error, but the end of the specified range of
   events to process has been reached and the program should terminate.
 */
-Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
-                          my_off_t pos, const char *logname)
+/**
+  Apply --offset, --start-datetime, --server-id, --stop-datetime and
+  --stop-position to an event, and print its position if it is to be
+  printed.
+
+  @param[out] skip  Set if the event is to be skipped.
+
+  @retval OK_CONTINUE No error, the program should continue.
+  @retval OK_STOP The event is past the end of the specified range; the
+  program should terminate.
+*/
+static Exit_status check_event_range(Log_event_type ev_type, my_time_t when,
+                                     ulong ev_server_id, my_off_t pos,
+                                     bool *skip)
 {
   char ll_buff[21];
-  Log_event_type ev_type= ev->get_type_code();
-  my_bool destroy_evt= TRUE;
-  DBUG_ENTER("process_event");
-  print_event_info->short_form= short_form;
-  Exit_status retval= OK_CONTINUE;
-  IO_CACHE *const head= &print_event_info->head_cache;
-
-  /* Bypass flashback settings to event */
-  ev->is_flashback= opt_flashback;
-#ifdef WHEN_FLASHBACK_REVIEW_READY
-  ev->need_flashback_review= opt_flashback_review;
-#endif
+  *skip= true;
 
   /*
     Format events are not concerned by --offset and such, we always need to
     read them to be able to process the wanted events.
   */
   if (((rec_count >= offset) &&
-       (ev->when >= start_datetime)) ||
+       (when >= start_datetime)) ||
       (ev_type == FORMAT_DESCRIPTION_EVENT))
   {
     if (ev_type != FORMAT_DESCRIPTION_EVENT)
@@ -1064,19 +1066,43 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
         events.
       */
       if (ev_type != ROTATE_EVENT &&
-          server_id && (server_id != ev->server_id))
-        goto end;
+          server_id && (server_id != ev_server_id))
+        return OK_CONTINUE;
     }
-    if ((ev->when >= stop_datetime)
+    if ((when >= stop_datetime)
         || (pos >= stop_position_mot))
     {
       /* end the program */
-      retval= OK_STOP;
-      goto end;
+      return OK_STOP;
     }
     if (!short_form && !opt_flashback)
       fprintf(result_file, "# at %s\n",llstr(pos,ll_buff));
+    *skip= false;
+  }
+  return OK_CONTINUE;
+}
+
+
+Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
+                          my_off_t pos, const char *logname)
+{
+  Log_event_type ev_type= ev->get_type_code();
+  my_bool destroy_evt= TRUE;
+  bool skip_evt;
+  DBUG_ENTER("process_event");
+  print_event_info->short_form= short_form;
+  Exit_status retval= OK_CONTINUE;
+  IO_CACHE *const head= &print_event_info->head_cache;
 
+  /* Bypass flashback settings to event */
+  ev->is_flashback= opt_flashback;
+#ifdef WHEN_FLASHBACK_REVIEW_READY
+  ev->need_flashback_review= opt_flashback_review;
+#endif
+
+  if ((retval= check_event_range(ev_type, ev->when, ev->server_id, pos,
+                                  &skip_evt)) == OK_CONTINUE && !skip_evt)
+  {
     if (!opt_hexdump)
       print_event_info->hexdump_from= 0; /* Disabled */
     else
@@ -1477,6 +1503,24 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
         destroy_evt= FALSE;
       break;
     }
+    case TRANSACTION_PAYLOAD_EVENT:
+    {
+      Transaction_payload_log_event *tpe= (Transaction_payload_log_event*) ev;
+      print_skip_replication_statement(print_event_info, ev);
+      ev->print(result_file, print_event_info);
+      if (head->error == -1)
+        goto err;
+      /* Print the events of the payload as if they were in the binlog */
+      for (uint i= 0; i < tpe->event_count; i++)
+      {
+        Log_event *payload_ev= tpe->events[i];
+        tpe->events[i]= NULL;
+        if ((retval= process_event(print_event_info, payload_ev, pos,
+                                   logname)) != OK_CONTINUE)
+          goto end;
+      }
+      break;
+    }
     case START_ENCRYPTION_EVENT:
       glob_description_event->start_decryption((Start_encryption_log_event*)ev);
       /* fall through */
@@ -1534,7 +1578,7 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
       }
     }
 
-    if (remote_opt)
+    if (remote_opt && !ev->event_owns_temp_buf)
       ev->temp_buf= 0;
     if (destroy_evt) /* destroy it later if not set (ignored table map) */
       delete ev;
@@ -1583,6 +1627,14 @@ static struct my_option my_options[] =
   {"debug-info", OPT_DEBUG_INFO, "Print some debug info at exit.",
    &debug_info_flag, &debug_info_flag,
    0, GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
+  {"decode-threads", 0,
+   "Number of threads that read and decode the events of local binlog "
+   "files ahead of printing them, including the base64 and --verbose "
+   "output of row events. The output is the same as without them. 0 "
+   "decodes all events in the main thread. Not used when reading from "
+   "stdin, or with --flashback.",
+   &opt_decode_threads, &opt_decode_threads, 0, GET_UINT, REQUIRED_ARG,
+   0, 0, 256, 0, 1, 0},
   {"default_auth", OPT_DEFAULT_AUTH,
    "Default authentication client-side plugin to use.",
    &opt_default_auth, &opt_default_auth, 0,
@@ -2803,6 +2855,708 @@ static Exit_status check_header(IO_CACHE* file,
   @retval OK_STOP No error, but the end of the specified range of
   events to process has been reached and the program should terminate.
 */
+/**
+  Whether a row event is one of those that mysqlbinlog prints through
+  print_row_event() (all except the pre-GA ones).
+*/
+static bool is_rows_event_type(Log_event_type type)
+{
+  return (LOG_EVENT_IS_WRITE_ROW(type) || LOG_EVENT_IS_UPDATE_ROW(type) ||
+          LOG_EVENT_IS_DELETE_ROW(type));
+}
+
+
+/**
+  Length of the part of a row event that holds its table id and flags.
+*/
+static uint rows_header_len(const Format_description_log_event *fdle,
+                            Log_event_type type)
+{
+  return fdle->common_header_len +
+    (fdle->post_header_len[type - 1] == 6 ? 4 : RW_FLAGS_OFFSET) + 2;
+}
+
+
+/**
+  Get the table id and flags of a row event from the first
+  rows_header_len() bytes of it, without decoding the rest.
+*/
+static void get_rows_header(const uchar *buf,
+                            const Format_description_log_event *fdle,
+                            ulong *table_id, uint16 *flags)
+{
+  Log_event_type type= (Log_event_type) buf[EVENT_TYPE_OFFSET];
+  const uchar *post_start= buf + fdle->common_header_len + RW_MAPID_OFFSET;
+  if (fdle->post_header_len[type - 1] == 6)
+  {
+    *table_id= uint4korr(post_start);
+    post_start+= 4;
+  }
+  else
+  {
+    *table_id= (ulong) uint6korr(post_start);
+    post_start+= RW_FLAGS_OFFSET;
+  }
+  *flags= uint2korr(post_start);
+}
+
+
+/**
+  Reads the events of a local binlog for dump_local_log_entries().
+
+  With --database or --table, a row event of a table that is filtered away
+  is recognized from its header and the id in it of the Table_map event of
+  its statement. Its body is skipped in the file without being read,
+  checksummed or decoded.
+
+  With --decode-threads, events are read ahead and decoded by a pool of
+  threads while the main thread prints the events before them. The events
+  are still printed one by one in binlog order, as the output of an event
+  depends on the events before it. A decode thread also renders the base64
+  and --verbose output of row events, which is where most of the time goes
+  otherwise. Events that change how the following events are read
+  (Format_description and Start_encryption) are read and printed by the
+  main thread after all events before them. If an event cannot be read or
+  decoded ahead, everything read after it is thrown away and it is read
+  again by the main thread, so that errors are reported as without decode
+  threads.
+*/
+class Local_log_reader
+{
+public:
+  /* An event read from the binlog, or a row event that was skipped */
+  struct Job
+  {
+    my_off_t pos;
+    Log_event *ev;
+    /* The event as read from the file, until it is decoded */
+    char *buf;
+    uint buf_len;
+    /* The Table_map event of a row event, for rendering --verbose output */
+    char *table_map;
+    uint table_map_len;
+    /* Type, header fields, table id and STMT_END_F of a row event */
+    Log_event_type type;
+    my_time_t when;
+    ulong server_id;
+    ulong table_id;
+    bool stmt_end;
+    /* Set if the body of the row event was skipped, ev is then NULL */
+    bool skipped;
+    /* Render the output of the row event in the decode thread */
+    bool render;
+    /* Decoding failed, the event has to be read again by the main thread */
+    bool failed;
+    bool done;
+  };
+
+  Local_log_reader(IO_CACHE *file_arg, bool seekable,
+                   PRINT_EVENT_INFO *print_event_info_arg);
+  ~Local_log_reader();
+  /* Start count decode threads. Return true on error. */
+  bool start_threads(uint count);
+  /*
+    Return the next event, or NULL where Log_event::read_log_event() would
+    return NULL, with the same file->error. The event of the job now
+    belongs to the caller. The job is valid until the next call.
+  */
+  Job *next();
+  /* Position of the event returned last, or of the one that failed */
+  my_off_t last_pos;
+
+  void run_thread();
+
+private:
+  /* A Table_map event of the current statement */
+  struct Table_map_info
+  {
+    ulong table_id;
+    ulong server_id;
+    /* Set if the table is filtered away by --database or --table */
+    bool ignored;
+    /* Copy of the event, kept for the decode threads */
+    char *buf;
+    uint len;
+  };
+
+  IO_CACHE *file;
+  PRINT_EVENT_INFO *print_event_info;
+  /* Row events can be skipped by their header */
+  bool fast_filter;
+  DYNAMIC_ARRAY stmt_tables;
+  uint ignored_tables;
+  Job serial_job;
+
+  /* With --decode-threads. The members below up to jobs are under lock. */
+  pthread_mutex_t lock;
+  /* Signaled when a job is queued, and on stop */
+  pthread_cond_t cond_queued;
+  /* Signaled when a job is done */
+  pthread_cond_t cond_done;
+  bool stop;
+  /*
+    The queue of jobs, in jobs[] modulo queue_size. From head to
+    decode_next they are taken by a decode thread or done, from decode_next
+    to tail they are waiting.
+  */
+  ulonglong head, decode_next, tail;
+  Job *jobs;
+  uint queue_size;
+  pthread_t *threads;
+  uint thread_count;
+  /* The job at head was returned by next() */
+  bool head_returned;
+  /* The next event has to be read by the main thread */
+  bool read_serially;
+
+  Job *read_serial();
+  bool skip_rows_body(Job *job);
+  void note_table_map(Table_map_log_event *map);
+  void note_rows(Job *job, ulong table_id, uint16 flags, bool ahead);
+  void clear_stmt_tables();
+  void fill_queue();
+  void discard_queue();
+  void free_job(Job *job);
+  void decode(Job *job, PRINT_EVENT_INFO *thd_print_event_info,
+              IO_CACHE *cache);
+};
+
+
+pthread_handler_t decode_thread(void *arg)
+{
+  my_thread_init();
+  ((Local_log_reader *) arg)->run_thread();
+  my_thread_end();
+  pthread_exit(0);
+  return 0;
+}
+
+
+Local_log_reader::Local_log_reader(IO_CACHE *file_arg, bool seekable,
+                                   PRINT_EVENT_INFO *print_event_info_arg)
+  : last_pos(0), file(file_arg), print_event_info(print_event_info_arg),
+    ignored_tables(0), stop(false), head(0), decode_next(0), tail(0),
+    jobs(NULL), queue_size(0), threads(NULL), thread_count(0),
+    head_returned(false), read_serially(false)
+{
+  /*
+    The body of a skipped event is skipped by seeking. Flashback needs all
+    row events, even those of tables that are filtered away.
+  */
+  fast_filter= seekable && (one_database || one_table) && !opt_flashback;
+  my_init_dynamic_array(&stmt_tables, sizeof(Table_map_info), 8, 8, MYF(0));
+}
+
+
+Local_log_reader::~Local_log_reader()
+{
+  if (thread_count)
+  {
+    pthread_mutex_lock(&lock);
+    stop= true;
+    pthread_cond_broadcast(&cond_queued);
+    pthread_mutex_unlock(&lock);
+    for (uint i= 0; i < thread_count; i++)
+      pthread_join(threads[i], NULL);
+    for (ulonglong i= head + head_returned; i < tail; i++)
+      free_job(&jobs[i % queue_size]);
+    pthread_mutex_destroy(&lock);
+    pthread_cond_destroy(&cond_queued);
+    pthread_cond_destroy(&cond_done);
+  }
+  my_free(threads);
+  my_free(jobs);
+  clear_stmt_tables();
+  delete_dynamic(&stmt_tables);
+}
+
+
+bool Local_log_reader::start_threads(uint count)
+{
+  queue_size= count * 16;
+  if (!(jobs= (Job *) my_malloc(queue_size * sizeof(Job), MYF(MY_WME))) ||
+      !(threads= (pthread_t *) my_malloc(count * sizeof(pthread_t),
+                                         MYF(MY_WME))))
+    return true;
+  pthread_mutex_init(&lock, NULL);
+  pthread_cond_init(&cond_queued, NULL);
+  pthread_cond_init(&cond_done, NULL);
+  for (; thread_count < count; thread_count++)
+  {
+    if (pthread_create(&threads[thread_count], NULL, decode_thread, this))
+    {
+      if (!thread_count)
+      {
+        pthread_mutex_destroy(&lock);
+        pthread_cond_destroy(&cond_queued);
+        pthread_cond_destroy(&cond_done);
+        return true;
+      }
+      break;
+    }
+  }
+  return false;
+}
+
+
+void Local_log_reader::free_job(Job *job)
+{
+  delete job->ev;
+  my_free(job->buf);
+  my_free(job->table_map);
+  job->ev= NULL;
+  job->buf= job->table_map= NULL;
+}
+
+
+void Local_log_reader::clear_stmt_tables()
+{
+  for (uint i= 0; i < stmt_tables.elements; i++)
+    my_free(dynamic_element(&stmt_tables, i, Table_map_info*)->buf);
+  reset_dynamic(&stmt_tables);
+  ignored_tables= 0;
+}
+
+
+/**
+  Remember a Table_map event that was read, for the row events after it in
+  the same statement.
+*/
+void Local_log_reader::note_table_map(Table_map_log_event *map)
+{
+  Table_map_info info, *found= NULL;
+  info.table_id= map->get_table_id();
+  info.server_id= map->server_id;
+  /*
+    The row events of the table are only skipped by their header if
+    process_event() will have put the table into m_table_map_ignored by
+    then. Until --offset and --start-datetime are reached, it may not.
+  */
+  info.ignored= fast_filter && offset == 0 && start_datetime == 0 &&
+    (shall_skip_database(map->get_db_name()) ||
+     shall_skip_table(map->get_table_name()));
+  info.buf= NULL;
+  info.len= 0;
+  if (thread_count && print_event_info->verbose && !info.ignored)
+  {
+    info.len= uint4korr(map->temp_buf + EVENT_LEN_OFFSET);
+    info.buf= (char *) my_memdup(map->temp_buf, info.len, MYF(0));
+  }
+
+  for (uint i= 0; i < stmt_tables.elements; i++)
+  {
+    Table_map_info *entry= dynamic_element(&stmt_tables, i, Table_map_info*);
+    if (entry->table_id == info.table_id)
+    {
+      found= entry;
+      ignored_tables-= entry->ignored;
+      my_free(entry->buf);
+      *entry= info;
+      break;
+    }
+  }
+  if (!found && insert_dynamic(&stmt_tables, (uchar *) &info))
+  {
+    my_free(info.buf);
+    return;
+  }
+  ignored_tables+= info.ignored;
+}
+
+
+/**
+  Note the table id and flags of a row event, and forget the Table_map
+  events at the end of the statement. If the event is read ahead, attach
+  its Table_map event for rendering it.
+*/
+void Local_log_reader::note_rows(Job *job, ulong table_id, uint16 flags,
+                                 bool ahead)
+{
+  job->table_id= table_id;
+  job->stmt_end= flags & Rows_log_event::STMT_END_F;
+  /*
+    Flashback changes the event before printing it. Compressed row events
+    are uncompressed when printed, so they are rendered when printed too.
+  */
+  job->render= ahead && !short_form && !opt_flashback &&
+    !LOG_EVENT_IS_ROW_COMPRESSED(job->type) &&
+    opt_base64_output_mode != BASE64_OUTPUT_NEVER &&
+    (opt_base64_output_mode != BASE64_OUTPUT_DECODE_ROWS ||
+     print_event_info->verbose);
+  if (job->render && print_event_info->verbose)
+  {
+    /*
+      Without its Table_map event, the event is rendered by the main
+      thread, where a table map of an earlier statement may be used.
+    */
+    job->render= false;
+    for (uint i= 0; i < stmt_tables.elements; i++)
+    {
+      Table_map_info *entry= dynamic_element(&stmt_tables, i,
+                                             Table_map_info*);
+      if (entry->table_id == table_id && entry->buf &&
+          (job->table_map= (char *) my_memdup(entry->buf, entry->len,
+                                              MYF(0))))
+      {
+        job->table_map_len= entry->len;
+        job->render= true;
+        break;
+      }
+    }
+  }
+  if (job->stmt_end)
+    clear_stmt_tables();
+}
+
+
+/**
+  If the event at the current position is a row event of a table that is
+  filtered away, fill in job from its header and skip the event.
+  Otherwise leave the position unchanged.
+
+  @retval true   The event was skipped
+  @retval false  The event has to be read
+*/
+bool Local_log_reader::skip_rows_body(Job *job)
+{
+  const Format_description_log_event *fdle= glob_description_event;
+  uchar header[LOG_EVENT_HEADER_LEN + RW_FLAGS_OFFSET + 2];
+  Log_event_type type;
+  uint len;
+  ulong table_id;
+  uint16 flags;
+
+  if (!ignored_tables || fdle->crypto_data.scheme ||
+      fdle->event_type_permutation ||
+      fdle->common_header_len > LOG_EVENT_HEADER_LEN)
+    return false;
+
+  if (my_b_read(file, header, fdle->common_header_len))
+    goto not_skipped;
+  type= (Log_event_type) header[EVENT_TYPE_OFFSET];
+  if (!is_rows_event_type(type) || type > fdle->number_of_event_types)
+    goto not_skipped;
+  len= rows_header_len(fdle, type);
+  if (my_b_read(file, header + fdle->common_header_len,
+                len - fdle->common_header_len) ||
+      uint4korr(header + EVENT_LEN_OFFSET) < len ||
+      job->pos + uint4korr(header + EVENT_LEN_OFFSET) > file->end_of_file)
+    goto not_skipped;
+
+  get_rows_header(header, fdle, &table_id, &flags);
+  for (uint i= 0; i < stmt_tables.elements; i++)
+  {
+    Table_map_info *entry= dynamic_element(&stmt_tables, i, Table_map_info*);
+    if (entry->table_id == table_id)
+    {
+      if (!entry->ignored ||
+          entry->server_id != uint4korr(header + SERVER_ID_OFFSET))
+        goto not_skipped;
+      job->type= type;
+      job->when= uint4korr(header);
+      job->server_id= uint4korr(header + SERVER_ID_OFFSET);
+      job->skipped= true;
+      note_rows(job, table_id, flags, false);
+      my_b_seek(file, job->pos + uint4korr(header + EVENT_LEN_OFFSET));
+      return true;
+    }
+  }
+
+not_skipped:
+  file->error= 0;
+  my_b_seek(file, job->pos);
+  return false;
+}
+
+
+Local_log_reader::Job *Local_log_reader::read_serial()
+{
+  Job *job= &serial_job;
+  bzero(job, sizeof(*job));
+  job->pos= last_pos= my_b_tell(file);
+  if (fast_filter && skip_rows_body(job))
+    return job;
+  if (!(job->ev= Log_event::read_log_event(file, 0, glob_description_event,
+                                           opt_verify_binlog_checksum)))
+    return NULL;
+  job->type= job->ev->get_type_code();
+  if (job->type == TABLE_MAP_EVENT)
+    note_table_map((Table_map_log_event *) job->ev);
+  else if (is_rows_event_type(job->type))
+  {
+    Rows_log_event *rev= (Rows_log_event *) job->ev;
+    note_rows(job, rev->get_table_id(), rev->get_flags(~0), false);
+  }
+  return job;
+}
+
+
+/**
+  Read events ahead into the queue, until it is full or an event has to be
+  read by the main thread.
+*/
+void Local_log_reader::fill_queue()
+{
+  while (!read_serially && tail - head < queue_size)
+  {
+    Job *job= &jobs[tail % queue_size];
+    String packet;
+    const char *error= 0;
+
+    bzero(job, sizeof(*job));
+    job->pos= my_b_tell(file);
+    if (fast_filter && skip_rows_body(job))
+      job->done= true;
+    else
+    {
+      /*
+        Errors and the end of the file are left to read_serial(), and so
+        are events that change how the following events are read.
+      */
+      if (Log_event::read_log_event(file, &packet, glob_description_event,
+                                    BINLOG_CHECKSUM_ALG_OFF))
+        goto serial;
+      job->type= (Log_event_type) packet[EVENT_TYPE_OFFSET];
+      if (job->type == FORMAT_DESCRIPTION_EVENT ||
+          job->type == START_EVENT_V3 ||
+          job->type == START_ENCRYPTION_EVENT ||
+          glob_description_event->event_type_permutation)
+        goto serial;
+
+      job->buf_len= packet.length();
+      job->buf= packet.release();
+      if (job->type == TABLE_MAP_EVENT)
+      {
+        /* Decoded here, to be able to filter its row events */
+        if (!(job->ev= Log_event::read_log_event(job->buf, job->buf_len,
+                                                 &error,
+                                                 glob_description_event,
+                                                 opt_verify_binlog_checksum)))
+        {
+          my_free(job->buf);
+          goto serial;
+        }
+        job->ev->register_temp_buf(job->buf, true);
+        job->buf= NULL;
+        note_table_map((Table_map_log_event *) job->ev);
+        job->done= true;
+      }
+      else if (is_rows_event_type(job->type) &&
+               job->type <= glob_description_event->number_of_event_types &&
+               job->buf_len >= rows_header_len(glob_description_event,
+                                               job->type))
+      {
+        ulong table_id;
+        uint16 flags;
+        get_rows_header((uchar *) job->buf, glob_description_event,
+                        &table_id, &flags);
+        note_rows(job, table_id, flags, true);
+      }
+    }
+
+    pthread_mutex_lock(&lock);
+    tail++;
+    pthread_cond_signal(&cond_queued);
+    pthread_mutex_unlock(&lock);
+  }
+  return;
+
+serial:
+  file->error= 0;
+  my_b_seek(file, jobs[tail % queue_size].pos);
+  read_serially= true;
+}
+
+
+/**
+  Throw away all queued jobs, after the decode threads are done with them.
+*/
+void Local_log_reader::discard_queue()
+{
+  pthread_mutex_lock(&lock);
+  decode_next= tail;
+  for (ulonglong i= head; i < tail; i++)
+  {
+    Job *job= &jobs[i % queue_size];
+    while (!job->done)
+      pthread_cond_wait(&cond_done, &lock);
+    free_job(job);
+  }
+  head= tail;
+  pthread_mutex_unlock(&lock);
+  /* The statement of the event to read next is not known */
+  clear_stmt_tables();
+}
+
+
+Local_log_reader::Job *Local_log_reader::next()
+{
+  Job *job;
+
+  if (!thread_count)
+    return read_serial();
+
+  if (head_returned)
+  {
+    jobs[head % queue_size].ev= NULL;
+    head++;
+    head_returned= false;
+  }
+
+  if (head == tail && read_serially)
+  {
+    read_serially= false;
+    return read_serial();
+  }
+  fill_queue();
+  if (head == tail)
+  {
+    read_serially= false;
+    return read_serial();
+  }
+
+  job= &jobs[head % queue_size];
+  pthread_mutex_lock(&lock);
+  while (!job->done)
+    pthread_cond_wait(&cond_done, &lock);
+  pthread_mutex_unlock(&lock);
+
+  if (job->failed)
+  {
+    my_off_t pos= job->pos;
+    discard_queue();
+    read_serially= false;
+    my_b_seek(file, pos);
+    return read_serial();
+  }
+  last_pos= job->pos;
+  head_returned= true;
+  return job;
+}
+
+
+void Local_log_reader::run_thread()
+{
+  PRINT_EVENT_INFO thd_print_event_info;
+  IO_CACHE cache;
+  bool can_render= (thd_print_event_info.init_ok() &&
+                    !open_cached_file(&cache, NULL, NULL, 0,
+                                      MYF(MY_WME | MY_NABP)));
+
+  thd_print_event_info.short_form= short_form;
+  thd_print_event_info.verbose= print_event_info->verbose;
+  thd_print_event_info.base64_output_mode= opt_base64_output_mode;
+  strmov(thd_print_event_info.delimiter, print_event_info->delimiter);
+
+  pthread_mutex_lock(&lock);
+  for (;;)
+  {
+    while (!stop && decode_next == tail)
+      pthread_cond_wait(&cond_queued, &lock);
+    if (stop)
+      break;
+    Job *job= &jobs[decode_next++ % queue_size];
+    if (job->done)
+      continue;
+    pthread_mutex_unlock(&lock);
+    decode(job, can_render ? &thd_print_event_info : NULL, &cache);
+    pthread_mutex_lock(&lock);
+    job->done= true;
+    pthread_cond_signal(&cond_done);
+  }
+  pthread_mutex_unlock(&lock);
+  if (can_render)
+    close_cached_file(&cache);
+}
+
+
+/**
+  Decode an event in a decode thread, and render the output of a row
+  event into Log_event::rendered_base64.
+
+  glob_description_event does not change while there are queued jobs.
+*/
+void Local_log_reader::decode(Job *job,
+                              PRINT_EVENT_INFO *thd_print_event_info,
+                              IO_CACHE *cache)
+{
+  const char *error= 0;
+  Log_event *ev;
+  LEX_STRING rendered;
+
+  if (!(ev= Log_event::read_log_event(job->buf, job->buf_len, &error,
+                                      glob_description_event,
+                                      opt_verify_binlog_checksum)))
+  {
+    my_free(job->buf);
+    my_free(job->table_map);
+    job->buf= job->table_map= NULL;
+    job->failed= true;
+    return;
+  }
+  ev->register_temp_buf(job->buf, true);
+  job->buf= NULL;
+  job->ev= ev;
+  if (!job->render || !thd_print_event_info)
+    goto end;
+
+  if (job->table_map)
+  {
+    Table_map_log_event *map;
+    size_t len_to= 0;
+    const char *db_to;
+
+    if (!(map= (Table_map_log_event *)
+          Log_event::read_log_event(job->table_map, job->table_map_len,
+                                    &error, glob_description_event, FALSE)))
+      goto end;
+    map->register_temp_buf(job->table_map, true);
+    job->table_map= NULL;
+    db_to= binlog_filter->get_rewrite_db(map->get_db_name(), &len_to);
+    if ((len_to && map->rewrite_db(db_to, len_to, glob_description_event)) ||
+        thd_print_event_info->m_table_map.set_table(map->get_table_id(), map))
+    {
+      delete map;
+      goto end;
+    }
+  }
+
+  ev->is_flashback= false;
+  ev->print_base64_data(cache, thd_print_event_info, !job->stmt_end);
+  if (!cache->error && !copy_event_cache_to_string_and_reinit(cache, &rendered))
+    ev->rendered_base64.reset(rendered.str, (uint32) rendered.length,
+                              (uint32) rendered.length, &my_charset_bin);
+  else
+    reinit_io_cache(cache, WRITE_CACHE, 0, FALSE, TRUE);
+  thd_print_event_info->m_table_map.clear_tables();
+
+end:
+  my_free(job->table_map);
+  job->table_map= NULL;
+}
+
+
+/**
+  Process a row event that was skipped by its header, as process_event()
+  processes the event of a table that is filtered away.
+*/
+static Exit_status process_skipped_rows(PRINT_EVENT_INFO *print_event_info,
+                                        Local_log_reader::Job *job)
+{
+  bool skip;
+  Exit_status retval= check_event_range(job->type, job->when, job->server_id,
+                                        job->pos, &skip);
+  if (retval == OK_CONTINUE && !skip)
+  {
+    DBUG_ASSERT(print_event_info->m_table_map_ignored.get_table(job->table_id));
+    if (print_row_event(print_event_info, NULL, job->table_id, job->stmt_end))
+      retval= ERROR_STOP;
+  }
+  rec_count++;
+  return retval;
+}
+
+
 static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
                                           const char* logname)
 {
@@ -2879,34 +3633,48 @@ static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
     error("Failed reading from file.");
     goto err;
   }
-  for (;;)
   {
-    char llbuff[21];
-    my_off_t old_off = my_b_tell(file);
+    Local_log_reader reader(file, fd >= 0, print_event_info);
 
-    Log_event* ev = Log_event::read_log_event(file, 0, glob_description_event,
-                                              opt_verify_binlog_checksum);
-    if (!ev)
+    /* Flashback keeps the events of a statement until its end */
+    if (opt_decode_threads && fd >= 0 && !opt_flashback &&
+        reader.start_threads(opt_decode_threads))
     {
-      /*
-        if binlog wasn't closed properly ("in use" flag is set) don't complain
-        about a corruption, but treat it as EOF and move to the next binlog.
-      */
-      if (glob_description_event->flags & LOG_EVENT_BINLOG_IN_USE_F)
-        file->error= 0;
-      else if (file->error)
+      error("Could not start decode threads.");
+      goto err;
+    }
+
+    for (;;)
+    {
+      char llbuff[21];
+      Local_log_reader::Job *job= reader.next();
+
+      if (!job)
       {
-        error("Could not read entry at offset %s: "
-              "Error in log format or read error.",
-              llstr(old_off,llbuff));
-        goto err;
+        /*
+          if binlog wasn't closed properly ("in use" flag is set) don't
+          complain about a corruption, but treat it as EOF and move to the
+          next binlog.
+        */
+        if (glob_description_event->flags & LOG_EVENT_BINLOG_IN_USE_F)
+          file->error= 0;
+        else if (file->error)
+        {
+          error("Could not read entry at offset %s: "
+                "Error in log format or read error.",
+                llstr(reader.last_pos,llbuff));
+          goto err;
+        }
+        // file->error == 0 means EOF, that's OK, we break in this case
+        goto end;
       }
-      // file->error == 0 means EOF, that's OK, we break in this case
-      goto end;
+      if (job->skipped)
+        retval= process_skipped_rows(print_event_info, job);
+      else
+        retval= process_event(print_event_info, job->ev, job->pos, logname);
+      if (retval != OK_CONTINUE)
+        goto end;
     }
-    if ((retval= process_event(print_event_info, ev, old_off, logname)) !=
-        OK_CONTINUE)
-      goto end;
   }
 
   /* NOTREACHED */
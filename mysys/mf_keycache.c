@@ -5212,6 +5212,67 @@ int init_partitioned_key_cache(PARTITIONED_KEY_CACHE_CB *keycache,
 } 
 
 
+/*
+  Resize the partitions of a partitioned key cache one by one
+
+  SYNOPSIS
+    resize_partition_by_partition()
+    keycache            pointer to the control block of a partitioned key cache
+    use_mem             total memory to use for the new key cache
+    division_limit      new division limit (if not zero)
+    age_threshold       new age threshold (if not zero)
+    changed_blocks_hash_size  number of hash buckets for the changed blocks
+                        of each partition
+
+  DESCRIPTION
+    The function resizes each simple key cache of the partitioned key cache
+    in turn, giving it an equal share of use_mem. While a partition is being
+    flushed and re-initialized, requests for its blocks bypass the cache,
+    but all other partitions stay fully operational.
+    The block size of the partitions is not changed, so read/write requests
+    that are split by keycache->key_cache_block_size remain valid for every
+    partition during the whole operation.
+
+  RETURN VALUE
+    total number of blocks in the key cache partitions, if successful,
+    <= 0 - if one of the partitions could not be resized. Partitions
+    already resized are left in their new state, the caller is supposed
+    to rebuild the whole key cache in this case.
+*/
+
+static
+int resize_partition_by_partition(PARTITIONED_KEY_CACHE_CB *keycache,
+                                  size_t use_mem, uint division_limit,
+                                  uint age_threshold,
+                                  uint changed_blocks_hash_size)
+{
+  uint i;
+  uint partitions= keycache->partitions;
+  size_t mem_per_cache= use_mem / partitions;
+  int blocks= 0;
+  DBUG_ENTER("resize_partition_by_partition");
+
+  for (i= 0; i < partitions; i++)
+  {
+    SIMPLE_KEY_CACHE_CB *partition= keycache->partition_array[i];
+    int cnt= 0;
+    if (!prepare_resize_simple_key_cache(partition, 0))
+    {
+      cnt= init_simple_key_cache(partition, keycache->key_cache_block_size,
+                                 mem_per_cache, division_limit, age_threshold,
+                                 changed_blocks_hash_size);
+      partition->hash_factor= partitions;
+    }
+    finish_resize_simple_key_cache(partition);
+    if (cnt <= 0)
+      DBUG_RETURN(-1);
+    blocks+= cnt;
+  }
+  keycache->key_cache_mem_size= mem_per_cache * partitions;
+  DBUG_RETURN(blocks);
+}
+
+
 /*
   Resize a partitioned key cache
 
@@ -5242,7 +5303,12 @@ int init_partitioned_key_cache(PARTITIONED_KEY_CACHE_CB *keycache,
     0 - otherwise.
 
   NOTES.
-    The function first calls prepare_resize_simple_key_cache for each simple
+    If the size of the key cache blocks does not change, the partitions
+    are resized one after another by resize_partition_by_partition(), so
+    that at any moment only one partition is bypassed by read/write
+    requests.
+    Otherwise, or if a partition fails to get its share of memory, the
+    function first calls prepare_resize_simple_key_cache for each simple
     key cache effectively flushing all dirty pages from it and destroying
     the key cache. Then init_partitioned_key_cache is called. This call builds
     a new array of simple key caches containing the same number of elements
@@ -5272,6 +5338,12 @@ int resize_partitioned_key_cache(PARTITIONED_KEY_CACHE_CB *keycache,
     end_partitioned_key_cache(keycache, 0);
     DBUG_RETURN(-1);
   }
+  if (key_cache_block_size == keycache->key_cache_block_size &&
+      (blocks= resize_partition_by_partition(keycache, use_mem,
+                                             division_limit, age_threshold,
+                                             changed_blocks_hash_size)) > 0)
+    DBUG_RETURN(blocks);
+  blocks= -1;
   for (i= 0; i < partitions; i++)
   {
     err|= prepare_resize_simple_key_cache(keycache->partition_array[i], 1);
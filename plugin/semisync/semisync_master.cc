@@ -1043,10 +1043,6 @@ int ReplSemiSyncMaster::readSlaveReply(NET *net, uint32 server_id,
                                        const char *event_buf)
 {
   const char *kWho = "ReplSemiSyncMaster::readSlaveReply";
-  const unsigned char *packet;
-  char     log_file_name[FN_REFLEN];
-  my_off_t log_file_pos;
-  ulong    log_file_len = 0;
   ulong    packet_len;
   int      result = -1;
   struct timespec start_ts;
@@ -1103,18 +1099,37 @@ int ReplSemiSyncMaster::readSlaveReply(NET *net, uint32 server_id,
     }
   }
 
-  if (packet_len == packet_error || packet_len < REPLY_BINLOG_NAME_OFFSET)
+  if (packet_len == packet_error)
   {
-    if (packet_len == packet_error)
-      sql_print_error("Read semi-sync reply network error: %s (errno: %d)",
-                      net->last_error, net->last_errno);
-    else
-      sql_print_error("Read semi-sync reply length error: %s (errno: %d)",
-                      net->last_error, net->last_errno);
+    sql_print_error("Read semi-sync reply network error: %s (errno: %d)",
+                    net->last_error, net->last_errno);
+    goto l_end;
+  }
+
+  result = reportReplyPacket(server_id, net->read_pos, packet_len);
+
+ l_end:
+  return function_exit(kWho, result);
+}
+
+int ReplSemiSyncMaster::reportReplyPacket(uint32 server_id,
+                                          const unsigned char *packet,
+                                          ulong packet_len)
+{
+  const char *kWho = "ReplSemiSyncMaster::reportReplyPacket";
+  char     log_file_name[FN_REFLEN];
+  my_off_t log_file_pos;
+  ulong    log_file_len = 0;
+  int      result = -1;
+
+  function_enter(kWho);
+
+  if (packet_len < REPLY_BINLOG_NAME_OFFSET)
+  {
+    sql_print_error("Read semi-sync reply length error: %lu", packet_len);
     goto l_end;
   }
 
-  packet = net->read_pos;
   if (packet[REPLY_MAGIC_NUM_OFFSET] != ReplSemiSyncMaster::kPacketMagicNum)
   {
     sql_print_error("Read semi-sync reply magic number error");
@@ -1131,7 +1146,7 @@ int ReplSemiSyncMaster::readSlaveReply(NET *net, uint32 server_id,
   strncpy(log_file_name, (const char*)packet + REPLY_BINLOG_NAME_OFFSET, log_file_len);
   log_file_name[log_file_len] = 0;
 
-  if (trc_level & kTraceDetail)
+  if (trace_level_ & kTraceDetail)
     sql_print_information("%s: Got reply (%s, %lu)",
                           kWho, log_file_name, (ulong)log_file_pos);
 
@@ -1141,6 +1156,30 @@ int ReplSemiSyncMaster::readSlaveReply(NET *net, uint32 server_id,
   return function_exit(kWho, result);
 }
 
+int ReplSemiSyncMaster::flushSlaveEvent(NET *net, const char *event_buf)
+{
+  assert((unsigned char)event_buf[1] == kPacketMagicNum);
+  if ((unsigned char)event_buf[2] != kPacketFlagSync)
+    return 0;
+
+  /* Send the event now, the slave will reply to it on its own. */
+  if (net_flush(net))
+  {
+    sql_print_error("Semi-sync master failed on net_flush() "
+                    "of an event waiting for slave reply");
+    return -1;
+  }
+  /*
+    The slave starts a new packet sequence for its reply, which the ack
+    receiver reads, and expects the next event as the packet after it.
+    Do what readSlaveReply() does when it reads the reply itself.
+  */
+  net_clear(net, 0);
+  net->pkt_nr++;
+  net->compress_pkt_nr++;
+  return 0;
+}
+
 
 int ReplSemiSyncMaster::resetMaster()
 {
@@ -585,6 +585,31 @@ class ReplSemiSyncMaster
    */
   int readSlaveReply(NET *net, uint32 server_id, const char *event_buf);
 
+  /* Report a reply packet read from a slave, see readSlaveReply().
+   *
+   * Input:
+   *  server_id    - (IN)  slave server id number
+   *  packet       - (IN)  the reply packet
+   *  packet_len   - (IN)  length of the reply packet
+   *
+   * Return:
+   *  0: success;  non-zero: error
+   */
+  int reportReplyPacket(uint32 server_id, const unsigned char *packet,
+                        ulong packet_len);
+
+  /* Flush an event that requires a reply to the slave without waiting for
+   * the reply, when the AckReceiver reads the replies of the slave.
+   *
+   * Input:
+   *  net          - (IN)  the connection to the slave
+   *  event_buf    - (IN)  pointer to the event packet
+   *
+   * Return:
+   *  0: success;  non-zero: error
+   */
+  int flushSlaveEvent(NET *net, const char *event_buf);
+
   /* Export internal statistics for semi-sync replication. */
   void setExportStats();
 
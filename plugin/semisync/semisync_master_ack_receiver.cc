@@ -0,0 +1,292 @@
+/* Copyright (c) 2018, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+
+#include <my_global.h>
+#include "semisync_master_ack_receiver.h"
+#ifdef HAVE_POLL_H
+#include <poll.h>
+#endif
+
+/* How long the receiver waits in poll() before it checks for a stop */
+#define ACK_RECEIVER_POLL_TIMEOUT_MS 100
+
+pthread_handler_t ack_receiver_thread(void *arg)
+{
+  my_thread_init();
+  ((AckReceiver *) arg)->run();
+  my_thread_end();
+  pthread_exit(0);
+  return 0;
+}
+
+void AckReceiver::init()
+{
+  mysql_mutex_init(key_ss_mutex_LOCK_ack_receiver_,
+                   &LOCK_ack_receiver_, MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_ss_cond_COND_ack_receiver_,
+                  &COND_ack_receiver_, NULL);
+}
+
+void AckReceiver::cleanup()
+{
+  stop();
+  my_free(slaves_);
+  slaves_= NULL;
+  slave_count_= slave_alloc_= 0;
+  mysql_mutex_destroy(&LOCK_ack_receiver_);
+  mysql_cond_destroy(&COND_ack_receiver_);
+}
+
+int AckReceiver::start()
+{
+  const char *kWho = "AckReceiver::start";
+  pthread_attr_t attr;
+  int error;
+
+  mysql_mutex_assert_owner(&LOCK_ack_receiver_);
+  if (state_ != ST_DOWN)
+    return 0;
+
+  function_enter(kWho);
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+  error= mysql_thread_create(key_ss_thread_ack_receiver, &thread_, &attr,
+                             ack_receiver_thread, this);
+  pthread_attr_destroy(&attr);
+  if (error)
+    sql_print_error("Failed to start semi-sync ACK receiver thread "
+                    "(errno: %d)", error);
+  else
+    state_= ST_UP;
+  return function_exit(kWho, error);
+}
+
+void AckReceiver::stop()
+{
+  mysql_mutex_lock(&LOCK_ack_receiver_);
+  if (state_ != ST_UP)
+  {
+    mysql_mutex_unlock(&LOCK_ack_receiver_);
+    return;
+  }
+  state_= ST_STOPPING;
+  mysql_cond_broadcast(&COND_ack_receiver_);
+  mysql_mutex_unlock(&LOCK_ack_receiver_);
+
+  pthread_join(thread_, NULL);
+
+  mysql_mutex_lock(&LOCK_ack_receiver_);
+  state_= ST_DOWN;
+  mysql_mutex_unlock(&LOCK_ack_receiver_);
+}
+
+bool AckReceiver::can_poll(NET *net)
+{
+#ifdef HAVE_POLL
+  if (!net->vio)
+    return false;
+  enum enum_vio_type type= vio_type(net->vio);
+  return type == VIO_TYPE_TCPIP || type == VIO_TYPE_SOCKET;
+#else
+  return false;
+#endif
+}
+
+int AckReceiver::add_slave(THD *thd, uint32 server_id)
+{
+  int result= 0;
+
+  mysql_mutex_lock(&LOCK_ack_receiver_);
+  if (slave_count_ == slave_alloc_)
+  {
+    Slave *new_slaves= (Slave *) my_realloc(slaves_, (slave_alloc_ + 8) *
+                                            sizeof(Slave),
+                                            MYF(MY_ALLOW_ZERO_PTR));
+    if (!new_slaves)
+    {
+      result= -1;
+      goto l_end;
+    }
+    slaves_= new_slaves;
+    slave_alloc_+= 8;
+  }
+
+  if ((result= start()))
+    goto l_end;
+
+  slaves_[slave_count_].thd= thd;
+  slaves_[slave_count_].vio= thd->net.vio;
+  slaves_[slave_count_].server_id= server_id;
+  slaves_[slave_count_].compress= thd->net.compress;
+  slaves_[slave_count_].failed= false;
+  slave_count_++;
+  slaves_version_++;
+  mysql_cond_broadcast(&COND_ack_receiver_);
+
+ l_end:
+  mysql_mutex_unlock(&LOCK_ack_receiver_);
+  return result;
+}
+
+void AckReceiver::remove_slave(THD *thd)
+{
+  mysql_mutex_lock(&LOCK_ack_receiver_);
+  /* Wait until the receiver is done reading a reply from this slave */
+  while (reading_thd_ == thd)
+    mysql_cond_wait(&COND_ack_receiver_, &LOCK_ack_receiver_);
+  for (uint i= 0; i < slave_count_; i++)
+  {
+    if (slaves_[i].thd == thd)
+    {
+      slaves_[i]= slaves_[--slave_count_];
+      slaves_version_++;
+      break;
+    }
+  }
+  mysql_mutex_unlock(&LOCK_ack_receiver_);
+}
+
+/*
+  The slave list is only changed under LOCK_ack_receiver_. The receiver
+  releases the mutex while it waits in poll() and while it reads a reply,
+  so that a slow slave does not block add_slave() and remove_slave() for
+  the others. The slave being read is kept in reading_thd_, and
+  remove_slave() waits until the read is over, so a dump thread cannot end
+  while its connection is being read.
+*/
+void AckReceiver::run()
+{
+#ifdef HAVE_POLL
+  THD *thd;
+  NET net;
+  struct pollfd *fds= NULL;
+  uint fds_alloc= 0;
+  uint nfds= 0;
+  ulonglong version= slaves_version_ - 1;
+
+  thd= new THD(next_thread_id());
+  thd->system_thread= SYSTEM_THREAD_GENERIC;
+  thd->thread_stack= (char*) &thd;           /* Set approximate stack start */
+  thd->store_globals();
+  thd->security_ctx->skip_grants();
+  thd->set_command(COM_DAEMON);
+  my_net_init(&net, NULL, thd, MYF(0));
+
+  sql_print_information("Starting semi-sync ACK receiver thread");
+
+  mysql_mutex_lock(&LOCK_ack_receiver_);
+  while (state_ == ST_UP)
+  {
+    if (version != slaves_version_)
+    {
+      if (slave_count_ > fds_alloc)
+      {
+        struct pollfd *new_fds=
+          (struct pollfd *) my_realloc(fds, slave_alloc_ * sizeof(*fds),
+                                       MYF(MY_ALLOW_ZERO_PTR));
+        if (!new_fds)
+        {
+          /* Try again later, the dump threads read the replies meanwhile */
+          sql_print_error("Semi-sync ACK receiver out of memory");
+          mysql_mutex_unlock(&LOCK_ack_receiver_);
+          my_sleep(ACK_RECEIVER_POLL_TIMEOUT_MS * 1000);
+          mysql_mutex_lock(&LOCK_ack_receiver_);
+          continue;
+        }
+        fds= new_fds;
+        fds_alloc= slave_alloc_;
+      }
+      for (uint i= 0; i < slave_count_; i++)
+      {
+        /* poll() ignores negative descriptors */
+        fds[i].fd= slaves_[i].failed ? -1 : vio_fd(slaves_[i].vio);
+        fds[i].events= POLLIN;
+      }
+      nfds= slave_count_;
+      version= slaves_version_;
+    }
+
+    if (nfds == 0)
+    {
+      mysql_cond_wait(&COND_ack_receiver_, &LOCK_ack_receiver_);
+      continue;
+    }
+
+    mysql_mutex_unlock(&LOCK_ack_receiver_);
+    int ret= poll(fds, nfds, ACK_RECEIVER_POLL_TIMEOUT_MS);
+    mysql_mutex_lock(&LOCK_ack_receiver_);
+
+    /* On a timeout, an error, or if a slave left during poll(), poll again */
+    if (ret <= 0 || version != slaves_version_)
+      continue;
+
+    for (uint i= 0; i < nfds; i++)
+    {
+      if (!fds[i].revents)
+        continue;
+      /* slaves_ may be reallocated while the mutex is released */
+      Slave slave= slaves_[i];
+      reading_thd_= slave.thd;
+      mysql_mutex_unlock(&LOCK_ack_receiver_);
+
+      net.vio= slave.vio;
+      net.compress= slave.compress;
+      net.error= 0;
+      net_clear(&net, 0);
+      ulong packet_len= my_net_read(&net);
+      if (packet_len != packet_error)
+        (void) master_->reportReplyPacket(slave.server_id, net.read_pos,
+                                          packet_len);
+      else if (trace_level_ & kTraceDetail)
+        sql_print_information("Semi-sync ACK receiver stopped reading "
+                              "replies of slave (server_id: %u): %s "
+                              "(errno: %d)", slave.server_id,
+                              net.last_error, net.last_errno);
+      thd->clear_error();
+
+      mysql_mutex_lock(&LOCK_ack_receiver_);
+      reading_thd_= NULL;
+      mysql_cond_broadcast(&COND_ack_receiver_);
+      if (packet_len == packet_error)
+      {
+        /*
+          Most likely the slave disconnected. Its dump thread will notice
+          when it next writes, and remove the slave.
+        */
+        for (uint j= 0; j < slave_count_; j++)
+        {
+          if (slaves_[j].thd == slave.thd)
+          {
+            slaves_[j].failed= true;
+            slaves_version_++;
+            break;
+          }
+        }
+      }
+      /* The slave list changed, the remaining replies are read after poll */
+      if (version != slaves_version_)
+        break;
+    }
+  }
+  mysql_mutex_unlock(&LOCK_ack_receiver_);
+
+  sql_print_information("Stopping semi-sync ACK receiver thread");
+  net.vio= NULL;
+  net_end(&net);
+  my_free(fds);
+  delete thd;
+#endif
+}
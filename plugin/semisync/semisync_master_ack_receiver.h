@@ -0,0 +1,108 @@
+/* Copyright (c) 2018, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+
+#ifndef SEMISYNC_MASTER_ACK_RECEIVER_H
+#define SEMISYNC_MASTER_ACK_RECEIVER_H
+
+#include "semisync_master.h"
+
+#ifdef HAVE_PSI_INTERFACE
+extern PSI_mutex_key key_ss_mutex_LOCK_ack_receiver_;
+extern PSI_cond_key key_ss_cond_COND_ack_receiver_;
+extern PSI_thread_key key_ss_thread_ack_receiver;
+#endif
+
+/**
+  @class AckReceiver
+
+  Reads the replies of all semi-sync slaves in one thread.
+
+  Without it, a binlog dump thread that sends an event requiring a reply
+  blocks until the reply arrives, and only then sends the next event. The
+  ack receiver instead polls the sockets of all semi-sync slaves and
+  reports each reply to ReplSemiSyncMaster as soon as it arrives, which
+  wakes up the waiting transactions. The dump threads just flush such
+  events and go on sending.
+
+  A dump thread registers its connection with add_slave() when it starts,
+  and removes it with remove_slave() before it ends. Only plain socket
+  connections can be polled; for other connections (SSL, named pipes and
+  shared memory), the dump thread reads the replies itself as before.
+*/
+class AckReceiver : public Trace {
+ public:
+  AckReceiver(ReplSemiSyncMaster *master)
+    : master_(master), slaves_(NULL), slave_count_(0), slave_alloc_(0),
+      slaves_version_(0), reading_thd_(NULL), state_(ST_DOWN)
+  {}
+
+  void init();
+  void cleanup();
+
+  /* Start the receiver thread. Return: 0 success; non-zero: error */
+  int start();
+  /* Stop the receiver thread and wait for it to exit */
+  void stop();
+
+  /* Whether the replies of the slave connected through net can be polled */
+  static bool can_poll(NET *net);
+
+  /*
+    Start reading the replies of a slave. thd is the slave's binlog dump
+    thread.
+
+    Return: 0 success; non-zero: error
+  */
+  int add_slave(THD *thd, uint32 server_id);
+  /*
+    Stop reading the replies of a slave. When this returns, the receiver
+    no longer uses the connection of thd.
+  */
+  void remove_slave(THD *thd);
+
+  /* The body of the receiver thread */
+  void run();
+
+ private:
+  enum state_t { ST_DOWN, ST_UP, ST_STOPPING };
+
+  struct Slave {
+    THD *thd;
+    Vio *vio;
+    uint32 server_id;
+    bool compress;
+    /* Set after a read error, the slave is not polled any more. */
+    bool failed;
+  };
+
+  ReplSemiSyncMaster *master_;
+
+  /* Protects all members below */
+  mysql_mutex_t LOCK_ack_receiver_;
+  /* Signaled when the slave list or the state changes */
+  mysql_cond_t COND_ack_receiver_;
+
+  Slave *slaves_;
+  uint slave_count_, slave_alloc_;
+  /* Incremented on every change to slaves_ */
+  ulonglong slaves_version_;
+  /* The dump thread of the slave whose reply is being read, if any */
+  THD *reading_thd_;
+  state_t state_;
+  pthread_t thread_;
+};
+
+#endif /* SEMISYNC_MASTER_ACK_RECEIVER_H */
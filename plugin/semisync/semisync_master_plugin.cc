@@ -18,9 +18,11 @@
 
 #include <my_global.h>
 #include "semisync_master.h"
+#include "semisync_master_ack_receiver.h"
 #include "sql_class.h"                          // THD
 
 static ReplSemiSyncMaster repl_semisync;
+static AckReceiver ack_receiver(&repl_semisync);
 
 C_MODE_START
 
@@ -94,6 +96,15 @@ int repl_semi_binlog_dump_start(Binlog_transmit_param *param,
   
   if (semi_sync_slave)
   {
+    THD *thd= current_thd;
+    if (AckReceiver::can_poll(&thd->net) &&
+        ack_receiver.add_slave(thd, param->server_id))
+    {
+      sql_print_error("Failed to register slave (server_id: %d) with the "
+                      "semi-sync ACK receiver", param->server_id);
+      return 1;
+    }
+
     /* One more semi-sync slave */
     repl_semisync.add_slave();
     
@@ -119,6 +130,7 @@ int repl_semi_binlog_dump_end(Binlog_transmit_param *param)
                         param->server_id);
   if (semi_sync_slave)
   {
+    ack_receiver.remove_slave(current_thd);
     /* One less semi-sync slave */
     repl_semisync.remove_slave();
   }
@@ -153,9 +165,15 @@ int repl_semi_after_send_event(Binlog_transmit_param *param,
       Possible errors in reading slave reply are ignored deliberately
       because we do not want dump thread to quit on this. Error
       messages are already reported.
+
+      The ACK receiver reads the replies of the slaves it can poll, so
+      their dump threads go on sending the next events right away.
     */
-    (void) repl_semisync.readSlaveReply(&thd->net,
-                                        param->server_id, event_buf);
+    if (AckReceiver::can_poll(&thd->net))
+      (void) repl_semisync.flushSlaveEvent(&thd->net, event_buf);
+    else
+      (void) repl_semisync.readSlaveReply(&thd->net,
+                                          param->server_id, event_buf);
     thd->clear_error();
   }
   return 0;
@@ -270,6 +288,7 @@ static void fix_rpl_semi_sync_master_trace_level(MYSQL_THD thd,
 {
   *(unsigned long *)ptr= *(unsigned long *)val;
   repl_semisync.setTraceLevel(rpl_semi_sync_master_trace_level);
+  ack_receiver.trace_level_= rpl_semi_sync_master_trace_level;
   return;
 }
 
@@ -391,17 +410,28 @@ static SHOW_VAR semi_sync_master_status_vars[]= {
 
 #ifdef HAVE_PSI_INTERFACE
 PSI_mutex_key key_ss_mutex_LOCK_binlog_;
+PSI_mutex_key key_ss_mutex_LOCK_ack_receiver_;
 
 static PSI_mutex_info all_semisync_mutexes[]=
 {
-  { &key_ss_mutex_LOCK_binlog_, "LOCK_binlog_", 0}
+  { &key_ss_mutex_LOCK_binlog_, "LOCK_binlog_", 0},
+  { &key_ss_mutex_LOCK_ack_receiver_, "LOCK_ack_receiver_", 0}
 };
 
 PSI_cond_key key_ss_cond_COND_binlog_send_;
+PSI_cond_key key_ss_cond_COND_ack_receiver_;
 
 static PSI_cond_info all_semisync_conds[]=
 {
-  { &key_ss_cond_COND_binlog_send_, "COND_binlog_send_", 0}
+  { &key_ss_cond_COND_binlog_send_, "COND_binlog_send_", 0},
+  { &key_ss_cond_COND_ack_receiver_, "COND_ack_receiver_", 0}
+};
+
+PSI_thread_key key_ss_thread_ack_receiver;
+
+static PSI_thread_info all_semisync_threads[]=
+{
+  { &key_ss_thread_ack_receiver, "ack_receiver", PSI_FLAG_GLOBAL}
 };
 #endif /* HAVE_PSI_INTERFACE */
 
@@ -425,6 +455,9 @@ static void init_semisync_psi_keys(void)
   count= array_elements(all_semisync_conds);
   mysql_cond_register(category, all_semisync_conds, count);
 
+  count= array_elements(all_semisync_threads);
+  mysql_thread_register(category, all_semisync_threads, count);
+
   count= array_elements(all_semisync_stages);
   mysql_stage_register(category, all_semisync_stages, count);
 }
@@ -438,6 +471,7 @@ static int semi_sync_master_plugin_init(void *p)
 
   if (repl_semisync.initObject())
     return 1;
+  ack_receiver.init();
   if (register_trans_observer(&trans_observer, p))
     return 1;
   if (register_binlog_storage_observer(&storage_observer, p))
@@ -464,6 +498,7 @@ static int semi_sync_master_plugin_deinit(void *p)
     sql_print_error("unregister_binlog_transmit_observer failed");
     return 1;
   }
+  ack_receiver.cleanup();
   repl_semisync.cleanup();
   sql_print_information("unregister_replicator OK");
   return 0;
@@ -106,12 +106,48 @@ static const char *ha_partition_ext[]=
 };
 
 
+static MYSQL_THDVAR_UINT(scan_threads, PLUGIN_VAR_RQCMDARG,
+  "Number of threads that read the partitions of a partitioned MyISAM "
+  "table in parallel during a table scan of a SELECT. Each thread scans "
+  "one partition at a time. 0 scans the partitions one after another in "
+  "the connection thread. Tables with BLOB columns are always scanned "
+  "in the connection thread.",
+  NULL, NULL, 0, 0, 64, 0);
+
+static struct st_mysql_sys_var *partition_sys_vars[]=
+{
+  MYSQL_SYSVAR(scan_threads),
+  NULL
+};
+
+/* Rows queued per worker thread of a parallel table scan */
+#define PARALLEL_SCAN_ROWS_PER_THREAD 64
+
+
 #ifdef HAVE_PSI_INTERFACE
 PSI_mutex_key key_partition_auto_inc_mutex;
+static PSI_mutex_key key_partition_LOCK_parallel_scan;
+static PSI_cond_key key_partition_COND_parallel_scan_rows,
+                    key_partition_COND_parallel_scan_space;
+static PSI_thread_key key_thread_partition_scan;
 
 static PSI_mutex_info all_partition_mutexes[]=
 {
-  { &key_partition_auto_inc_mutex, "Partition_share::auto_inc_mutex", 0}
+  { &key_partition_auto_inc_mutex, "Partition_share::auto_inc_mutex", 0},
+  { &key_partition_LOCK_parallel_scan, "Partition_parallel_scan::lock", 0}
+};
+
+static PSI_cond_info all_partition_conds[]=
+{
+  { &key_partition_COND_parallel_scan_rows,
+    "Partition_parallel_scan::cond_rows", 0},
+  { &key_partition_COND_parallel_scan_space,
+    "Partition_parallel_scan::cond_space", 0}
+};
+
+static PSI_thread_info all_partition_threads[]=
+{
+  { &key_thread_partition_scan, "partition_scan", 0}
 };
 
 static void init_partition_psi_keys(void)
@@ -121,6 +157,10 @@ static void init_partition_psi_keys(void)
 
   count= array_elements(all_partition_mutexes);
   mysql_mutex_register(category, all_partition_mutexes, count);
+  count= array_elements(all_partition_conds);
+  mysql_cond_register(category, all_partition_conds, count);
+  count= array_elements(all_partition_threads);
+  mysql_thread_register(category, all_partition_threads, count);
 }
 #endif /* HAVE_PSI_INTERFACE */
 
@@ -347,6 +387,8 @@ void ha_partition::init_handler_variables()
   m_extra_cache_size= 0;
   m_extra_prepare_for_update= FALSE;
   m_extra_cache_part_id= NO_CURRENT_PART_ID;
+  m_parallel_scan= NULL;
+  m_table_scanned= FALSE;
   m_handler_status= handler_not_initialized;
   m_part_field_array= NULL;
   m_ordered_rec_buffer= NULL;
@@ -3719,6 +3761,8 @@ int ha_partition::close(void)
   DBUG_ENTER("ha_partition::close");
 
   DBUG_ASSERT(table->s == table_share);
+  if (m_parallel_scan)
+    end_parallel_scan();
   destroy_record_priority_queue();
   free_partition_bitmaps();
   DBUG_ASSERT(m_part_info);
@@ -4825,9 +4869,12 @@ int ha_partition::rnd_init(bool scan)
       is already in use
     */
     rnd_end();
-    late_extra_cache(part_id);
-    if ((error= m_file[part_id]->ha_rnd_init(scan)))
-      goto err;
+    if (!start_parallel_scan(part_id))
+    {
+      late_extra_cache(part_id);
+      if ((error= m_file[part_id]->ha_rnd_init(scan)))
+        goto err;
+    }
   }
   else
   {
@@ -4878,7 +4925,9 @@ int ha_partition::rnd_end()
   case 2:                                       // Error
     break;
   case 1:
-    if (NO_CURRENT_PART_ID != m_part_spec.start_part)         // Table scan
+    if (m_parallel_scan)
+      end_parallel_scan();
+    else if (NO_CURRENT_PART_ID != m_part_spec.start_part)    // Table scan
     {
       late_extra_no_cache(m_part_spec.start_part);
       m_file[m_part_spec.start_part]->ha_rnd_end();
@@ -4927,6 +4976,9 @@ int ha_partition::rnd_next(uchar *buf)
   uint part_id= m_part_spec.start_part;
   DBUG_ENTER("ha_partition::rnd_next");
 
+  if (m_parallel_scan)
+    DBUG_RETURN(parallel_scan_next(buf));
+
   /* upper level will increment this once again at end of call */
   decrement_statistics(&SSV::ha_read_rnd_next_count);
 
@@ -4991,6 +5043,287 @@ int ha_partition::rnd_next(uchar *buf)
 }
 
 
+pthread_handler_t partition_scan_thread(void *arg)
+{
+  my_thread_init();
+  ((ha_partition *) arg)->parallel_scan_worker();
+  my_thread_end();
+  pthread_exit(0);
+  return 0;
+}
+
+
+/*
+  Start a table scan that reads the partitions in worker threads
+
+  SYNOPSIS
+    start_parallel_scan()
+    part_id                     First partition to scan
+
+  RETURN VALUE
+    TRUE                        The workers were started
+    FALSE                       The partitions should be scanned one after
+                                another in this thread
+
+  DESCRIPTION
+    Only done for partition_scan_threads > 0, when all partitions are MyISAM
+    and the scan does not change the table, and only for the first table
+    scan of the handler in a statement. The workers call the handlers
+    of the partitions without a THD, and the rows they return must not
+    point into buffers of the handler, so tables with BLOB columns are not
+    scanned in parallel.
+
+    The workers call rnd_next() of the partitions directly rather than
+    ha_rnd_next(), as the statistics of the THD cannot be updated from
+    other threads. Each row returned by ha_partition::rnd_next() is counted
+    once as usual.
+*/
+
+bool ha_partition::start_parallel_scan(uint part_id)
+{
+  Partition_parallel_scan *scan;
+  uint threads= THDVAR(ha_thd(), scan_threads);
+  uint parts, row_size, slots, i;
+  pthread_t *thread_ids;
+  uchar *rows, *last_ref;
+  DBUG_ENTER("ha_partition::start_parallel_scan");
+
+  /*
+    Only the first table scan of a statement is done in parallel. Rescans,
+    e.g. of the inner table of a nested loop join or in a dependent
+    subquery, would create and join the workers once per outer row.
+  */
+  if (m_table_scanned)
+    DBUG_RETURN(FALSE);
+  m_table_scanned= TRUE;
+
+  if (!threads || !m_myisam || get_lock_type() != F_RDLCK ||
+      m_extra_prepare_for_update || table_share->blob_fields ||
+      (parts= bitmap_bits_set(&m_part_info->read_partitions)) < 2)
+    DBUG_RETURN(FALSE);
+  set_if_smaller(threads, parts);
+
+  row_size= ALIGN_SIZE(table_share->reclength + m_ref_length);
+  slots= threads * PARALLEL_SCAN_ROWS_PER_THREAD;
+  if (!my_multi_malloc(MYF(MY_WME),
+                       &scan, sizeof(*scan),
+                       &thread_ids, threads * sizeof(pthread_t),
+                       &rows, slots * row_size,
+                       &last_ref, m_ref_length,
+                       NullS))
+    DBUG_RETURN(FALSE);
+
+  mysql_mutex_init(key_partition_LOCK_parallel_scan, &scan->lock,
+                   MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_partition_COND_parallel_scan_rows, &scan->cond_rows,
+                  NULL);
+  mysql_cond_init(key_partition_COND_parallel_scan_space, &scan->cond_space,
+                  NULL);
+  scan->threads= thread_ids;
+  scan->running= threads;
+  scan->next_part= part_id;
+  scan->error= 0;
+  scan->error_part= part_id;
+  scan->abort= FALSE;
+  scan->use_cache= m_extra_cache;
+  scan->cache_size= m_extra_cache_size;
+  scan->rows= rows;
+  scan->row_size= row_size;
+  scan->slots= slots;
+  scan->first= scan->count= 0;
+  scan->last_ref= last_ref;
+  m_parallel_scan= scan;
+
+  mysql_mutex_lock(&scan->lock);
+  for (i= 0; i < threads; i++)
+  {
+    if (mysql_thread_create(key_thread_partition_scan, &thread_ids[i], NULL,
+                            partition_scan_thread, this))
+      break;
+  }
+  scan->thread_count= i;
+  scan->running= i;
+  mysql_mutex_unlock(&scan->lock);
+
+  if (!i)
+  {
+    end_parallel_scan();
+    DBUG_RETURN(FALSE);
+  }
+  DBUG_PRINT("info", ("Scanning %u partitions in %u threads", parts, i));
+  DBUG_RETURN(TRUE);
+}
+
+
+/*
+  Stop the workers of a parallel table scan and free the scan
+*/
+
+void ha_partition::end_parallel_scan()
+{
+  Partition_parallel_scan *scan= m_parallel_scan;
+  DBUG_ENTER("ha_partition::end_parallel_scan");
+
+  mysql_mutex_lock(&scan->lock);
+  scan->abort= TRUE;
+  mysql_cond_broadcast(&scan->cond_space);
+  mysql_mutex_unlock(&scan->lock);
+
+  for (uint i= 0; i < scan->thread_count; i++)
+    pthread_join(scan->threads[i], NULL);
+
+  mysql_cond_destroy(&scan->cond_space);
+  mysql_cond_destroy(&scan->cond_rows);
+  mysql_mutex_destroy(&scan->lock);
+  my_free(scan);
+  m_parallel_scan= NULL;
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  Return the next row queued by the workers of a parallel table scan
+
+  SYNOPSIS
+    parallel_scan_next()
+    buf                         buffer that should be filled with data
+
+  RETURN VALUE
+    HA_ERR_END_OF_FILE          All partitions are scanned
+    >0                          Error code of a worker
+    0                           Success
+*/
+
+int ha_partition::parallel_scan_next(uchar *buf)
+{
+  Partition_parallel_scan *scan= m_parallel_scan;
+  uint reclength= table_share->reclength;
+  int error= 0;
+  DBUG_ENTER("ha_partition::parallel_scan_next");
+
+  mysql_mutex_lock(&scan->lock);
+  while (!scan->count && scan->running && !scan->error)
+    mysql_cond_wait(&scan->cond_rows, &scan->lock);
+
+  if (scan->error)
+  {
+    error= scan->error;
+    m_last_part= scan->error_part;
+  }
+  else if (!scan->count)
+    error= HA_ERR_END_OF_FILE;
+  else
+  {
+    uchar *row= scan->rows + scan->first * scan->row_size;
+    memcpy(buf, row, reclength);
+    memcpy(scan->last_ref, row + reclength, m_ref_length);
+    m_last_part= uint2korr(row + reclength);
+    scan->first= (scan->first + 1) % scan->slots;
+    scan->count--;
+    mysql_cond_signal(&scan->cond_space);
+    table->status= 0;
+  }
+  mysql_mutex_unlock(&scan->lock);
+  DBUG_RETURN(error);
+}
+
+
+/*
+  Queue a row read by a worker of a parallel table scan
+
+  RETURN VALUE
+    TRUE                        The scan was aborted
+    FALSE                       Success
+*/
+
+bool ha_partition::queue_parallel_scan_row(uchar *row)
+{
+  Partition_parallel_scan *scan= m_parallel_scan;
+  bool aborted;
+
+  mysql_mutex_lock(&scan->lock);
+  while (scan->count == scan->slots && !scan->abort && !scan->error)
+    mysql_cond_wait(&scan->cond_space, &scan->lock);
+  if (!(aborted= scan->abort || scan->error))
+  {
+    uint slot= (scan->first + scan->count) % scan->slots;
+    memcpy(scan->rows + slot * scan->row_size, row, scan->row_size);
+    scan->count++;
+    mysql_cond_signal(&scan->cond_rows);
+  }
+  mysql_mutex_unlock(&scan->lock);
+  return aborted;
+}
+
+
+void ha_partition::parallel_scan_worker()
+{
+  Partition_parallel_scan *scan= m_parallel_scan;
+  uint reclength= table_share->reclength;
+  uchar *row;
+  int error= 0;
+  uint part_id= NO_CURRENT_PART_ID;
+
+  if (!(row= (uchar*) my_malloc(scan->row_size, MYF(MY_ZEROFILL))))
+    error= HA_ERR_OUT_OF_MEM;
+
+  mysql_mutex_lock(&scan->lock);
+  while (!error && !scan->abort && !scan->error &&
+         scan->next_part < m_tot_parts)
+  {
+    handler *file;
+    part_id= scan->next_part;
+    scan->next_part= bitmap_get_next_set(&m_part_info->read_partitions,
+                                         part_id);
+    mysql_mutex_unlock(&scan->lock);
+
+    file= m_file[part_id];
+    if (scan->use_cache)
+    {
+      if (scan->cache_size == 0)
+        (void) file->extra(HA_EXTRA_CACHE);
+      else
+        (void) file->extra_opt(HA_EXTRA_CACHE, scan->cache_size);
+    }
+    if (!(error= file->ha_rnd_init(1)))
+    {
+      uint pad_length= m_ref_length - PARTITION_BYTES_IN_POS -
+                       file->ref_length;
+      int2store(row + reclength, part_id);
+      if (pad_length)
+        memset(row + reclength + PARTITION_BYTES_IN_POS + file->ref_length,
+               0, pad_length);
+      while (!(error= file->rnd_next(row)) || error == HA_ERR_RECORD_DELETED)
+      {
+        if (error)
+          continue;                             // Probably MyISAM
+        file->position(row);
+        memcpy(row + reclength + PARTITION_BYTES_IN_POS, file->ref,
+               file->ref_length);
+        if (queue_parallel_scan_row(row))
+          break;
+      }
+      if (error == HA_ERR_END_OF_FILE)
+        error= 0;
+      (void) file->ha_rnd_end();
+    }
+    if (scan->use_cache)
+      (void) file->extra(HA_EXTRA_NO_CACHE);
+    mysql_mutex_lock(&scan->lock);
+  }
+
+  if (error && !scan->error)
+  {
+    scan->error= error;
+    scan->error_part= part_id;
+  }
+  scan->running--;
+  mysql_cond_broadcast(&scan->cond_rows);
+  mysql_mutex_unlock(&scan->lock);
+  my_free(row);
+}
+
+
 /*
   Save position of current row
 
@@ -5023,6 +5356,13 @@ void ha_partition::position(const uchar *record)
   DBUG_ASSERT(bitmap_is_set(&(m_part_info->read_partitions), m_last_part));
   DBUG_ENTER("ha_partition::position");
 
+  if (m_parallel_scan)
+  {
+    /* The worker thread saved the position when it read the row */
+    memcpy(ref, m_parallel_scan->last_ref, m_ref_length);
+    DBUG_VOID_RETURN;
+  }
+
   file->position(record);
   int2store(ref, m_last_part);
   memcpy((ref + PARTITION_BYTES_IN_POS), file->ref, file->ref_length);
@@ -7305,6 +7645,10 @@ int ha_partition::reset(void)
   uint i;
   DBUG_ENTER("ha_partition::reset");
 
+  /* In case the scan was not ended by rnd_end() */
+  if (m_parallel_scan)
+    end_parallel_scan();
+  m_table_scanned= FALSE;
   for (i= bitmap_get_first_set(&m_partitions_to_reset);
        i < m_tot_parts;
        i= bitmap_get_next_set(&m_partitions_to_reset, i))
@@ -9141,7 +9485,7 @@ maria_declare_plugin(partition)
   NULL, /* Plugin Deinit */
   0x0100, /* 1.0 */
   NULL,                       /* status variables                */
-  NULL,                       /* system variables                */
+  partition_sys_vars,         /* system variables                */
   "1.0",                      /* string version                  */
   MariaDB_PLUGIN_MATURITY_STABLE /* maturity                     */
 }
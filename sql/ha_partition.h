@@ -108,6 +108,44 @@ class Partition_share : public Handler_share
 
 extern "C" int cmp_key_rowid_part_id(void *ptr, uchar *ref1, uchar *ref2);
 
+/**
+  A table scan that reads the partitions in worker threads, see
+  ha_partition::start_parallel_scan(). Each worker scans one partition at
+  a time with the handler of that partition, and queues the rows it reads.
+  rnd_next() returns the queued rows in the order they arrive.
+*/
+struct Partition_parallel_scan
+{
+  mysql_mutex_t lock;
+  /* Signaled when a row is queued, a worker fails or a worker ends */
+  mysql_cond_t cond_rows;
+  /* Signaled when a queued row is read, or when the scan is aborted */
+  mysql_cond_t cond_space;
+  pthread_t *threads;
+  uint thread_count;
+  /* Number of workers that are still running */
+  uint running;
+  /* The next partition for a worker to scan, NO_CURRENT_PART_ID at the end */
+  uint next_part;
+  /* The first error of a worker, and the partition it happened in */
+  int error;
+  uint error_part;
+  /* Set by end_parallel_scan() to make the workers stop */
+  bool abort;
+  /* HA_EXTRA_CACHE was requested before the scan started */
+  bool use_cache;
+  uint cache_size;
+  /*
+    Ring buffer of queued rows. Each row is the record followed by its
+    position as returned by ha_partition::position().
+  */
+  uchar *rows;
+  uint row_size, slots, first, count;
+  /* Position of the row last returned by rnd_next() */
+  uchar *last_ref;
+};
+
+
 class ha_partition :public handler
 {
 private:
@@ -235,6 +273,10 @@ class ha_partition :public handler
   bool m_extra_prepare_for_update;
   /* Which partition has active cache */
   uint m_extra_cache_part_id;
+  /* Set while a table scan is done in worker threads */
+  Partition_parallel_scan *m_parallel_scan;
+  /* A table scan was started since the last reset() */
+  bool m_table_scanned;
 
   void init_handler_variables();
   /*
@@ -542,6 +584,9 @@ class ha_partition :public handler
   virtual int rnd_pos_by_record(uchar *record);
   virtual void position(const uchar * record);
 
+  /* The body of the worker threads of a parallel table scan */
+  void parallel_scan_worker();
+
   /*
     -------------------------------------------------------------------------
     MODULE index scan
@@ -672,6 +717,10 @@ class ha_partition :public handler
   int loop_extra_alter(enum ha_extra_function operations);
   void late_extra_cache(uint partition_id);
   void late_extra_no_cache(uint partition_id);
+  bool start_parallel_scan(uint part_id);
+  int parallel_scan_next(uchar *buf);
+  void end_parallel_scan();
+  bool queue_parallel_scan_row(uchar *row);
   void prepare_extra_cache(uint cachesize);
 public:
 
@@ -4080,11 +4080,32 @@ handler::ha_delete_all_rows()
   DBUG_ASSERT(table_share->tmp_table != NO_TMP_TABLE ||
               m_lock_type == F_WRLCK);
   mark_trx_read_write();
+  /* Invalidate the estimates of handler::ha_records_in_range() */
+  my_atomic_add64_explicit(&table_share->rows_changed_count, 1,
+                           MY_MEMORY_ORDER_RELAXED);
 
   return delete_all_rows();
 }
 
 
+/**
+  Exchange rows with another temporary table: public interface.
+
+  @sa handler::exchange_rows()
+*/
+
+int
+handler::ha_exchange_rows(handler *other)
+{
+  DBUG_ASSERT(table_share->tmp_table != NO_TMP_TABLE &&
+              other->table_share->tmp_table != NO_TMP_TABLE);
+  DBUG_ASSERT(inited == NONE && other->inited == NONE);
+  if (other->ht != ht)
+    return HA_ERR_WRONG_COMMAND;
+  return exchange_rows(other);
+}
+
+
 /**
   Truncate table: public interface.
 
@@ -4097,6 +4118,8 @@ handler::ha_truncate()
   DBUG_ASSERT(table_share->tmp_table != NO_TMP_TABLE ||
               m_lock_type == F_WRLCK);
   mark_trx_read_write();
+  my_atomic_add64_explicit(&table_share->rows_changed_count, 1,
+                           MY_MEMORY_ORDER_RELAXED);
 
   return truncate();
 }
@@ -4595,10 +4618,11 @@ void handler::update_global_table_stats()
 
   status_var_add(table->in_use->status_var.rows_read, rows_read);
   DBUG_ASSERT(rows_tmp_read == 0);
+  update_rows_changed_count();
 
   if (!table->in_use->userstat_running)
   {
-    rows_read= rows_changed= 0;
+    rows_read= rows_changed= rows_changed_counted= 0;
     return;
   }
 
@@ -4640,12 +4664,163 @@ void handler::update_global_table_stats()
   table_stats->rows_changed_x_indexes+= (rows_changed *
                                          (table->s->keys ? table->s->keys :
                                           1));
-  rows_read= rows_changed= 0;
+  rows_read= rows_changed= rows_changed_counted= 0;
 end:
   mysql_mutex_unlock(&LOCK_global_table_stats);
 }
 
 
+/*
+  Add the rows changed since the last call to the counter of the share
+*/
+
+void handler::update_rows_changed_count()
+{
+  if (rows_changed != rows_changed_counted)
+  {
+    my_atomic_add64_explicit(&table_share->rows_changed_count,
+                             (int64) (rows_changed - rows_changed_counted),
+                             MY_MEMORY_ORDER_RELAXED);
+    rows_changed_counted= rows_changed;
+  }
+}
+
+
+/*
+  An estimate of records_in_range() cached in TABLE::range_estimates.
+
+  The key is the index number followed by both ends of the range, see
+  range_estimate_key(). The estimate is used as long as no row of the table
+  was changed since it was made.
+*/
+
+struct Range_estimate
+{
+  uchar *key;
+  uint key_length, alloced_length;
+  ha_rows rows;
+  /* TABLE_SHARE::rows_changed_count when the estimate was made */
+  int64 rows_changed_count;
+};
+
+/* Longest key of a range estimate, longer ranges are not cached */
+#define RANGE_ESTIMATE_MAX_KEY (4 + 2 * (12 + MAX_KEY_LENGTH))
+
+static uint range_estimate_key(uchar *key, uint inx, key_range *min_key,
+                               key_range *max_key)
+{
+  uchar *pos= key;
+  key_range *ends[2]= { min_key, max_key };
+
+  int4store(pos, inx);
+  pos+= 4;
+  for (uint i= 0; i < 2; i++)
+  {
+    key_range *end= ends[i];
+    if (!end)
+    {
+      bzero(pos, 12);
+      pos+= 12;
+      continue;
+    }
+    if (end->length > MAX_KEY_LENGTH)
+      return 0;
+    pos[0]= 1;
+    pos[1]= (uchar) end->flag;
+    int8store(pos + 2, (ulonglong) end->keypart_map);
+    int2store(pos + 10, end->length);
+    memcpy(pos + 12, end->key, end->length);
+    pos+= 12 + end->length;
+  }
+  return (uint) (pos - key);
+}
+
+
+void free_range_estimates(TABLE *table)
+{
+  if (!table->range_estimates)
+    return;
+  for (ulong i= 0; i < table->range_estimates_size; i++)
+    my_free(table->range_estimates[i].key);
+  my_free(table->range_estimates);
+  table->range_estimates= NULL;
+  table->range_estimates_size= 0;
+}
+
+
+/*
+  The range optimizer asks for the same estimates again every time a
+  statement is optimized, and for InnoDB each estimate costs two dives into
+  the index. Keep the last estimates in the TABLE, which is used by one
+  thread at a time, so that repeated queries do not ask the engine again.
+
+  Partitioned tables are not cached, as their estimates depend on the
+  partitions that are left after pruning. Neither are tables with foreign
+  keys, whose rows a cascade changes without going through their handler,
+  nor MERGE tables, whose children can be changed directly. A MERGE table
+  increases the counter of a child it changes itself.
+*/
+
+ha_rows handler::ha_records_in_range(uint inx, key_range *min_key,
+                                     key_range *max_key)
+{
+  ulong size= range_estimate_cache_size;
+  uchar key[RANGE_ESTIMATE_MAX_KEY];
+  uint length;
+
+  if (!size || this != table->file ||
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+      table->part_info ||
+#endif
+      table_share->tmp_table == INTERNAL_TMP_TABLE ||
+      ht->db_type == DB_TYPE_MRG_MYISAM ||
+      !(length= range_estimate_key(key, inx, min_key, max_key)) ||
+      !can_switch_engines())
+    return records_in_range(inx, min_key, max_key);
+
+  if (table->range_estimates_size != size)
+  {
+    free_range_estimates(table);
+    if (!(table->range_estimates= (Range_estimate*)
+          my_malloc(size * sizeof(Range_estimate), MYF(MY_ZEROFILL))))
+      return records_in_range(inx, min_key, max_key);
+    table->range_estimates_size= size;
+  }
+
+  ulong nr1= 1, nr2= 4;
+  my_charset_bin.coll->hash_sort(&my_charset_bin, key, length, &nr1, &nr2);
+  Range_estimate *estimate= table->range_estimates + nr1 % size;
+  int64 changed= my_atomic_load64_explicit(&table_share->rows_changed_count,
+                                           MY_MEMORY_ORDER_RELAXED);
+  if (estimate->key_length == length &&
+      estimate->rows_changed_count == changed &&
+      !memcmp(estimate->key, key, length))
+  {
+    status_var_increment(table->in_use->status_var.range_estimate_cache_hits);
+    return estimate->rows;
+  }
+
+  status_var_increment(table->in_use->status_var.range_estimate_cache_misses);
+  ha_rows rows= records_in_range(inx, min_key, max_key);
+  if (rows == HA_POS_ERROR)
+    return rows;
+
+  if (estimate->alloced_length < length)
+  {
+    my_free(estimate->key);
+    estimate->key_length= estimate->alloced_length= 0;
+    if (!(estimate->key= (uchar*) my_malloc(length, MYF(0))))
+      return rows;
+    estimate->alloced_length= length;
+  }
+  memcpy(estimate->key, key, length);
+  estimate->key_length= length;
+  estimate->rows= rows;
+  estimate->rows_changed_count= changed;
+  return rows;
+}
+
+
 /*
   Updates the global index stats with this handler's accumulated index reads.
 */
@@ -6000,6 +6175,7 @@ int handler::ha_reset()
   /* Reset information about pushed engine conditions */
   cancel_pushed_idx_cond();
   /* Reset information about pushed index conditions */
+  update_rows_changed_count();
   DBUG_RETURN(reset());
 }
 
@@ -2736,6 +2736,8 @@ class handler :public Sql_alloc
   ulonglong rows_read;
   ulonglong rows_tmp_read;
   ulonglong rows_changed;
+  /* Part of rows_changed already added to TABLE_SHARE::rows_changed_count */
+  ulonglong rows_changed_counted;
   /* One bigger than needed to avoid to test if key == MAX_KEY */
   ulonglong index_rows_read[MAX_KEY+1];
 
@@ -2943,6 +2945,7 @@ class handler :public Sql_alloc
   int ha_bulk_update_row(const uchar *old_data, const uchar *new_data,
                          uint *dup_key_found);
   int ha_delete_all_rows();
+  int ha_exchange_rows(handler *other);
   int ha_truncate();
   int ha_reset_auto_increment(ulonglong value);
   int ha_optimize(THD* thd, HA_CHECK_OPT* check_opt);
@@ -2999,7 +3002,7 @@ class handler :public Sql_alloc
   { DBUG_ASSERT(false); return(false); }
   void reset_statistics()
   {
-    rows_read= rows_changed= rows_tmp_read= 0;
+    rows_read= rows_changed= rows_changed_counted= rows_tmp_read= 0;
     bzero(index_rows_read, sizeof(index_rows_read));
   }
   virtual void change_table_ptr(TABLE *table_arg, TABLE_SHARE *share)
@@ -3309,6 +3312,12 @@ class handler :public Sql_alloc
   virtual ha_rows records_in_range(uint inx, key_range *min_key,
                                    key_range *max_key)
     { return (ha_rows) 10; }
+  /*
+    records_in_range(), through the estimates cached in the TABLE, see
+    --range-estimate-cache-size.
+  */
+  ha_rows ha_records_in_range(uint inx, key_range *min_key,
+                              key_range *max_key);
   /*
     If HA_PRIMARY_KEY_REQUIRED_FOR_POSITION is set, then it sets ref
     (reference to the row, aka position, with the primary key given in
@@ -3480,6 +3489,7 @@ class handler :public Sql_alloc
   virtual bool auto_repair(int error) const { return 0; }
 
   void update_global_table_stats();
+  void update_rows_changed_count();
   void update_global_index_stats();
 
 #define CHF_CREATE_FLAG 0
@@ -4160,6 +4170,14 @@ class handler :public Sql_alloc
   */
   virtual int delete_all_rows()
   { return (my_errno=HA_ERR_WRONG_COMMAND); }
+  /**
+    Exchange the rows of this internal temporary table with the rows of
+    another one of the same engine and with the same record format.
+    If the handler doesn't support this, then this function will return
+    HA_ERR_WRONG_COMMAND and the caller has to copy the rows.
+  */
+  virtual int exchange_rows(handler *other)
+  { return HA_ERR_WRONG_COMMAND; }
   /**
     Quickly remove all rows from a table.
 
@@ -4445,6 +4463,7 @@ int binlog_log_row(TABLE* table,
 void print_keydup_error(TABLE *table, KEY *key, const char *msg, myf errflag);
 void print_keydup_error(TABLE *table, KEY *key, myf errflag);
 
+void free_range_estimates(TABLE *table);
 int del_global_index_stat(THD *thd, TABLE* table, KEY* key_info);
 int del_global_table_stat(THD *thd, LEX_CSTRING *db, LEX_CSTRING *table);
 #endif /* HANDLER_INCLUDED */
@@ -87,6 +87,12 @@ static int binlog_rollback(handlerton *hton, THD *thd, bool all);
 static int binlog_prepare(handlerton *hton, THD *thd, bool all);
 static int binlog_start_consistent_snapshot(handlerton *hton, THD *thd);
 
+/*
+  Max number of key hashes kept for one transaction, and for one writeset
+  group, with binlog_dependency_tracking=WRITESET.
+*/
+#define BINLOG_WRITESET_MAX_KEYS 25000
+
 static LEX_STRING const write_error_msg=
     { C_STRING_WITH_LEN("error writing to the binary log") };
 
@@ -106,6 +112,15 @@ static ulonglong binlog_status_var_num_group_commits;
 static ulonglong binlog_status_group_commit_trigger_count;
 static ulonglong binlog_status_group_commit_trigger_lock_wait;
 static ulonglong binlog_status_group_commit_trigger_timeout;
+static ulonglong binlog_status_flush_stage_queue;
+static ulonglong binlog_status_flush_stage_time;
+static ulonglong binlog_status_sync_stage_queue;
+static ulonglong binlog_status_sync_stage_time;
+static ulonglong binlog_status_sync_stage_syncs;
+static ulonglong binlog_status_commit_stage_queue;
+static ulonglong binlog_status_commit_stage_time;
+static ulonglong binlog_status_tail_cache_hits;
+static ulonglong binlog_status_tail_cache_misses;
 static char binlog_snapshot_file[FN_REFLEN];
 static ulonglong binlog_snapshot_position;
 
@@ -128,6 +143,24 @@ static SHOW_VAR binlog_status_vars_detail[]=
     (char *)&binlog_status_group_commit_trigger_lock_wait, SHOW_LONGLONG},
   {"group_commit_trigger_timeout",
     (char *)&binlog_status_group_commit_trigger_timeout, SHOW_LONGLONG},
+  {"flush_stage_queue",
+    (char *)&binlog_status_flush_stage_queue, SHOW_LONGLONG},
+  {"flush_stage_time",
+    (char *)&binlog_status_flush_stage_time, SHOW_LONGLONG},
+  {"sync_stage_queue",
+    (char *)&binlog_status_sync_stage_queue, SHOW_LONGLONG},
+  {"sync_stage_time",
+    (char *)&binlog_status_sync_stage_time, SHOW_LONGLONG},
+  {"sync_stage_syncs",
+    (char *)&binlog_status_sync_stage_syncs, SHOW_LONGLONG},
+  {"commit_stage_queue",
+    (char *)&binlog_status_commit_stage_queue, SHOW_LONGLONG},
+  {"commit_stage_time",
+    (char *)&binlog_status_commit_stage_time, SHOW_LONGLONG},
+  {"tail_cache_hits",
+    (char *)&binlog_status_tail_cache_hits, SHOW_LONGLONG},
+  {"tail_cache_misses",
+    (char *)&binlog_status_tail_cache_misses, SHOW_LONGLONG},
   {"snapshot_file",
     (char *)&binlog_snapshot_file, SHOW_CHAR},
   {"snapshot_position",
@@ -510,7 +543,8 @@ class binlog_cache_mngr {
                     ulong *param_ptr_binlog_stmt_cache_disk_use,
                     ulong *param_ptr_binlog_cache_use,
                     ulong *param_ptr_binlog_cache_disk_use)
-    : last_commit_pos_offset(0), using_xa(FALSE), xa_xid(0)
+    : last_commit_pos_offset(0), using_xa(FALSE), xa_xid(0),
+      writeset_unsafe(FALSE), trx_payload(NULL)
   {
      stmt_cache.set_binlog_cache_info(param_max_binlog_stmt_cache_size,
                                       param_ptr_binlog_stmt_cache_use,
@@ -519,6 +553,13 @@ class binlog_cache_mngr {
                                      param_ptr_binlog_cache_use,
                                      param_ptr_binlog_cache_disk_use);
      last_commit_pos_file[0]= 0;
+     my_init_dynamic_array(&writeset, sizeof(ulonglong), 16, 64, MYF(0));
+  }
+
+  ~binlog_cache_mngr()
+  {
+    delete_dynamic(&writeset);
+    my_free(trx_payload);
   }
 
   void reset(bool do_stmt, bool do_trx)
@@ -531,6 +572,10 @@ class binlog_cache_mngr {
       using_xa= FALSE;
       last_commit_pos_file[0]= 0;
       last_commit_pos_offset= 0;
+      reset_dynamic(&writeset);
+      writeset_unsafe= FALSE;
+      my_free(trx_payload);
+      trx_payload= NULL;
     }
   }
 
@@ -573,6 +618,26 @@ class binlog_cache_mngr {
   /* Set if we get an error during commit that must be returned from unlog(). */
   bool delayed_error;
 
+  /*
+    Hashes of the primary and unique key values modified by the transaction,
+    collected for binlog_dependency_tracking=WRITESET. writeset_unsafe is set
+    when the transaction did something the writeset can not describe
+    (statement events, tables without unique keys, foreign keys, ...).
+  */
+  DYNAMIC_ARRAY writeset;
+  bool writeset_unsafe;
+
+  /*
+    The transaction cache compressed by compress_trx_cache(), or NULL. It is
+    written as a Transaction_payload_log_event instead of the cache, unless
+    the binlog checksum was changed in the meantime.
+  */
+  uchar *trx_payload;
+  uint32 trx_payload_len, trx_payload_uncompressed_len;
+  ulong trx_payload_checksum;
+
+  bool compress_trx_cache(THD *thd);
+
 private:
 
   binlog_cache_mngr& operator=(const binlog_cache_mngr& info);
@@ -1727,6 +1792,96 @@ static int binlog_close_connection(handlerton *hton, THD *thd)
   DBUG_RETURN(0);
 }
 
+/*
+  Compress the events in the transaction cache into trx_payload
+  (--log-bin-compress-transactions).
+
+  The events in the cache have no checksum, and their end_log_pos is
+  relative to the start of the cache. In the payload, each event gets the
+  checksum of the binlog, so that it can be read with the
+  Format_description_log_event of the binlog, and its end_log_pos is
+  relative to the start of the payload.
+
+  The cache is only read. If anything fails, or the payload would not be
+  smaller, trx_payload is not set and the cache is written as usual.
+*/
+
+bool binlog_cache_mngr::compress_trx_cache(THD *thd)
+{
+  IO_CACHE *cache= &trx_cache.cache_log;
+  my_off_t cache_len= my_b_write_tell(cache);
+  ulong checksum= binlog_checksum_options;
+  uint checksum_len= (checksum != BINLOG_CHECKSUM_ALG_OFF ?
+                      BINLOG_CHECKSUM_LEN : 0);
+  uchar *events= NULL, *data= NULL, *compressed= NULL;
+  uint32 pos, data_len, count, compressed_len;
+  int read_error;
+  bool res= false;
+  DBUG_ENTER("binlog_cache_mngr::compress_trx_cache");
+
+  DBUG_ASSERT(!trx_payload);
+  /* The payload event must not be bigger than a slave can read */
+  if (cache_len < LOG_EVENT_HEADER_LEN ||
+      cache_len > thd->variables.max_allowed_packet)
+    DBUG_RETURN(false);
+
+  if (!(events= (uchar *) my_malloc((size_t) cache_len, MYF(MY_WME))) ||
+      reinit_io_cache(cache, READ_CACHE, 0, 0, 0))
+    goto end;
+  read_error= my_b_read(cache, events, (size_t) cache_len);
+  if (reinit_io_cache(cache, WRITE_CACHE, cache_len, 0, 0) || read_error)
+    goto end;
+
+  for (pos= 0, count= 0; pos < cache_len; count++)
+  {
+    uint32 ev_len;
+    if (cache_len - pos < LOG_EVENT_HEADER_LEN ||
+        (ev_len= uint4korr(events + pos + EVENT_LEN_OFFSET)) <
+        LOG_EVENT_HEADER_LEN ||
+        ev_len > cache_len - pos)
+      goto end;
+    pos+= ev_len;
+  }
+  data_len= (uint32) cache_len + count * checksum_len;
+  if (data_len > thd->variables.max_allowed_packet ||
+      !(data= (uchar *) my_malloc(data_len, MYF(MY_WME))))
+    goto end;
+
+  for (uint32 from= 0, to= 0; from < cache_len; )
+  {
+    uint32 ev_len= uint4korr(events + from + EVENT_LEN_OFFSET);
+    uchar *ev= data + to;
+    memcpy(ev, events + from, ev_len);
+    from+= ev_len;
+    to+= ev_len + checksum_len;
+    int4store(ev + EVENT_LEN_OFFSET, ev_len + checksum_len);
+    int4store(ev + LOG_POS_OFFSET, to);
+    if (checksum_len)
+      int4store(ev + ev_len, my_checksum(0, ev, ev_len));
+  }
+
+  compressed_len= binlog_get_compress_len(data_len);
+  if (!(compressed= (uchar *) my_malloc(compressed_len, MYF(MY_WME))) ||
+      binlog_buf_compress((const char *) data, (char *) compressed, data_len,
+                          &compressed_len) ||
+      compressed_len >= data_len)
+    goto end;
+
+  trx_payload= compressed;
+  trx_payload_len= compressed_len;
+  trx_payload_uncompressed_len= data_len;
+  trx_payload_checksum= checksum;
+  compressed= NULL;
+  res= true;
+
+end:
+  my_free(compressed);
+  my_free(data);
+  my_free(events);
+  DBUG_RETURN(res);
+}
+
+
 /*
   This function flushes a cache upon commit/rollback.
 
@@ -1770,6 +1925,11 @@ binlog_flush_cache(THD *thd, binlog_cache_mngr *cache_mngr,
     if (using_trx && thd->binlog_flush_pending_rows_event(TRUE, TRUE))
       DBUG_RETURN(1);
 
+    /* Compress before the group commit, so not under LOCK_log */
+    if (using_trx && opt_bin_log_compress_transactions &&
+        !cache_mngr->trx_cache.empty())
+      cache_mngr->compress_trx_cache(thd);
+
     /*
       Doing a commit or a rollback including non-transactional tables,
       i.e., ending a transaction where we might write the transaction
@@ -2664,7 +2824,8 @@ bool MYSQL_LOG::open(
   else if ((seek_offset= mysql_file_tell(file, MYF(MY_WME))))
     goto err;
 
-  if (init_io_cache(&log_file, file, IO_SIZE, io_cache_type, seek_offset, 0,
+  if (init_io_cache(&log_file, file, io_cache_size, io_cache_type,
+                    seek_offset, 0,
                     MYF(MY_WME | MY_NABP |
                         ((log_type == LOG_BIN) ? MY_WAIT_IF_FULL : 0))))
     goto err;
@@ -2709,7 +2870,7 @@ bool MYSQL_LOG::open(
 
 MYSQL_LOG::MYSQL_LOG()
   : name(0), write_error(FALSE), inited(FALSE), log_type(LOG_UNKNOWN),
-    log_state(LOG_CLOSED)
+    log_state(LOG_CLOSED), io_cache_size(IO_SIZE)
 {
   /*
     We don't want to initialize LOCK_Log here as such initialization depends on
@@ -3209,9 +3370,13 @@ MYSQL_BIN_LOG::MYSQL_BIN_LOG(uint *sync_period)
    num_commits(0), num_group_commits(0),
    group_commit_trigger_count(0), group_commit_trigger_timeout(0),
    group_commit_trigger_lock_wait(0),
+   flush_stage_time(0), sync_stage_time(0), commit_stage_time(0),
+   sync_stage_syncs(0),
+   sync_stage_queue(0), commit_stage_queue(0), writeset_group_id(0),
    sync_period_ptr(sync_period), sync_counter(0),
    state_file_deleted(false), binlog_state_recover_done(false),
-   is_relay_log(0), signal_cnt(0),
+   gtid_index_file(-1), gtid_index_last_offset(0), gtid_index_failed(false),
+   is_relay_log(0), relay_log_in_memory(0), signal_cnt(0),
    checksum_alg_reset(BINLOG_CHECKSUM_ALG_UNDEF),
    relay_log_checksum_alg(BINLOG_CHECKSUM_ALG_UNDEF),
    description_event_for_exec(0), description_event_for_queue(0),
@@ -3281,11 +3446,14 @@ void MYSQL_BIN_LOG::cleanup()
     mysql_mutex_destroy(&LOCK_xid_list);
     mysql_mutex_destroy(&LOCK_binlog_background_thread);
     mysql_mutex_destroy(&LOCK_binlog_end_pos);
+    tail_cache.destroy();
     mysql_cond_destroy(&update_cond);
     mysql_cond_destroy(&COND_queue_busy);
     mysql_cond_destroy(&COND_xid_list);
     mysql_cond_destroy(&COND_binlog_background_thread);
     mysql_cond_destroy(&COND_binlog_background_thread_end);
+    my_hash_free(&writeset_group);
+    free_root(&writeset_root, MYF(0));
   }
 
   /*
@@ -3329,6 +3497,11 @@ void MYSQL_BIN_LOG::init_pthread_objects()
 
   mysql_mutex_init(m_key_LOCK_binlog_end_pos, &LOCK_binlog_end_pos,
                    MY_MUTEX_INIT_SLOW);
+  tail_cache.init();
+
+  my_hash_init(&writeset_group, &my_charset_bin, 0, 0, sizeof(ulonglong),
+               NULL, NULL, HASH_UNIQUE);
+  init_alloc_root(&writeset_root, 8192, 0, MYF(0));
 }
 
 
@@ -3716,6 +3889,7 @@ bool MYSQL_BIN_LOG::open(const char *log_name,
     {
       /* update binlog_end_pos so that it can be read by after sync hook */
       reset_binlog_end_pos(log_file_name, offset);
+      open_gtid_index(offset);
 
       mysql_mutex_lock(&LOCK_commit_ordered);
       strmake_buf(last_commit_pos_file, log_file_name);
@@ -4130,11 +4304,12 @@ bool MYSQL_BIN_LOG::reset_logs(THD *thd, bool create_new_log,
       Without binlog, we cannot XA recover prepared-but-not-committed
       transactions in engines. So force a commit checkpoint first.
 
-      Note that we take and immediately
-      release LOCK_after_binlog_sync/LOCK_commit_ordered. This has
+      Note that we take and immediately release LOCK_binlog_sync/
+      LOCK_after_binlog_sync/LOCK_commit_ordered. This has
       the effect to ensure that any on-going group commit (in
       trx_group_commit_leader()) has completed before we request the checkpoint,
-      due to the chaining of LOCK_log and LOCK_commit_ordered in that function.
+      due to the chaining of LOCK_log, LOCK_binlog_sync, LOCK_after_binlog_sync
+      and LOCK_commit_ordered in that function.
       (We are holding LOCK_log, so no new group commit can start).
 
       Without this, it is possible (though perhaps unlikely) that the RESET
@@ -4143,7 +4318,9 @@ bool MYSQL_BIN_LOG::reset_logs(THD *thd, bool create_new_log,
       later would leave such transaction not recoverable.
     */
 
+    mysql_mutex_lock(&LOCK_binlog_sync);
     mysql_mutex_lock(&LOCK_after_binlog_sync);
+    mysql_mutex_unlock(&LOCK_binlog_sync);
     mysql_mutex_lock(&LOCK_commit_ordered);
     mysql_mutex_unlock(&LOCK_after_binlog_sync);
     mysql_mutex_unlock(&LOCK_commit_ordered);
@@ -4205,6 +4382,8 @@ bool MYSQL_BIN_LOG::reset_logs(THD *thd, bool create_new_log,
 
   for (;;)
   {
+    if (!is_relay_log)
+      delete_binlog_gtid_index(linfo.log_file_name);
     if ((error= my_delete(linfo.log_file_name, MYF(0))) != 0)
     {
       if (my_errno == ENOENT) 
@@ -4812,6 +4991,8 @@ int MYSQL_BIN_LOG::purge_index_entry(THD *thd, ulonglong *reclaimed_space,
         error= 0;
 
         DBUG_PRINT("info",("purging %s",log_info.log_file_name));
+        if (!is_relay_log)
+          delete_binlog_gtid_index(log_info.log_file_name);
         if (!my_delete(log_info.log_file_name, MYF(0)))
         {
           if (reclaimed_space)
@@ -5284,7 +5465,7 @@ bool MYSQL_BIN_LOG::append_no_lock(Log_event* ev)
   }
   bytes_written+= ev->data_written;
   DBUG_PRINT("info",("max_size: %lu",max_size));
-  if (flush_and_sync(0))
+  if (!relay_log_in_memory && flush_and_sync(0))
     goto err;
   if (my_b_append_tell(&log_file) > max_size)
     error= new_file_without_locking();
@@ -5343,7 +5524,11 @@ bool MYSQL_BIN_LOG::write_event_buffer(uchar* buf, uint len)
 
   error= 0;
   DBUG_PRINT("info",("max_size: %lu",max_size));
-  if (flush_and_sync(0))
+  /*
+    An in-memory relay log is written when the append buffer is full or the
+    file is rotated. The SQL thread reads the events from the append buffer.
+  */
+  if (!relay_log_in_memory && flush_and_sync(0))
     goto err;
   if (my_b_append_tell(&log_file) > max_size)
     error= new_file_without_locking();
@@ -5354,11 +5539,44 @@ bool MYSQL_BIN_LOG::write_event_buffer(uchar* buf, uint len)
   DBUG_RETURN(error);
 }
 
+void MYSQL_BIN_LOG::set_relay_log_in_memory(bool in_memory)
+{
+  DBUG_ASSERT(is_relay_log);
+  relay_log_in_memory= in_memory;
+  io_cache_size= in_memory ? (size_t) opt_relay_log_buffer_size : IO_SIZE;
+}
+
+
+bool MYSQL_BIN_LOG::flush_relay_log_buffer()
+{
+  bool error= 0;
+  if (!relay_log_in_memory)
+    return 0;
+  mysql_mutex_lock(&LOCK_log);
+  if (is_open())
+    error= flush_io_cache(&log_file);
+  mysql_mutex_unlock(&LOCK_log);
+  return error;
+}
+
+
 bool MYSQL_BIN_LOG::flush_and_sync(bool *synced)
 {
-  int err=0, fd=log_file.file;
+  bool need_sync;
   if (synced)
     *synced= 0;
+  if (flush_for_sync(&need_sync))
+    return 1;
+  if (!need_sync)
+    return 0;
+  if (synced)
+    *synced= 1;
+  return sync_binlog_file(log_file.file);
+}
+
+bool MYSQL_BIN_LOG::flush_for_sync(bool *need_sync)
+{
+  *need_sync= false;
   mysql_mutex_assert_owner(&LOCK_log);
   if (flush_io_cache(&log_file))
     return 1;
@@ -5366,14 +5584,18 @@ bool MYSQL_BIN_LOG::flush_and_sync(bool *synced)
   if (sync_period && ++sync_counter >= sync_period)
   {
     sync_counter= 0;
-    err= mysql_file_sync(fd, MYF(MY_WME|MY_SYNC_FILESIZE));
-    if (synced)
-      *synced= 1;
+    *need_sync= true;
+  }
+  return 0;
+}
+
+bool MYSQL_BIN_LOG::sync_binlog_file(File fd)
+{
+  int err= mysql_file_sync(fd, MYF(MY_WME|MY_SYNC_FILESIZE));
 #ifndef DBUG_OFF
-    if (opt_binlog_dbug_fsync_sleep > 0)
-      my_sleep(opt_binlog_dbug_fsync_sleep);
+  if (opt_binlog_dbug_fsync_sleep > 0)
+    my_sleep(opt_binlog_dbug_fsync_sleep);
 #endif
-  }
   return err;
 }
 
@@ -5713,10 +5935,114 @@ int THD::binlog_write_table_map(TABLE *table, bool is_transactional,
   if ((error= writer.write(&the_event)))
     DBUG_RETURN(error);
 
+  /*
+    Changes done through foreign keys (cascades, or the checks against the
+    parent table) are not visible in the writeset. can_switch_engines() is
+    false for tables that take part in a foreign key. Rows logged while
+    writeset tracking is off are not in the writeset either.
+  */
+  if (is_transactional &&
+      (opt_binlog_dependency_tracking != BINLOG_DEPENDENCY_WRITESET ||
+       !table->file->can_switch_engines()))
+    cache_mngr->writeset_unsafe= TRUE;
+
   binlog_table_maps++;
   DBUG_RETURN(0);
 }
 
+
+/**
+  Add the primary and unique key values of a logged row to the writeset
+  of the transaction.
+
+  Each key value is reduced to a 64-bit hash of the table name, the key
+  number and the key parts, using the collation of each key part so that
+  values which compare equal hash equal. A hash collision can only make
+  two transactions look dependent, never the other way around.
+
+  @param table             Table the row belongs to
+  @param is_transactional  The row is logged to the transactional cache
+  @param record            Row image, in table->record[0] format
+  @param cols              Columns known to be valid in record, or 0 if
+                           all are (inserted rows)
+*/
+
+void THD::binlog_add_row_to_writeset(TABLE *table, bool is_transactional,
+                                     const uchar *record,
+                                     const MY_BITMAP *cols)
+{
+  binlog_cache_mngr *const cache_mngr=
+    (binlog_cache_mngr*) thd_get_ha_data(this, binlog_hton);
+  my_ptrdiff_t ptrdiff= record - table->record[0];
+  bool found_key= FALSE;
+  DBUG_ENTER("THD::binlog_add_row_to_writeset");
+
+  if (!cache_mngr || cache_mngr->writeset_unsafe)
+    DBUG_VOID_RETURN;
+  if (opt_binlog_dependency_tracking != BINLOG_DEPENDENCY_WRITESET)
+  {
+    cache_mngr->writeset_unsafe= TRUE;
+    DBUG_VOID_RETURN;
+  }
+
+  if (variables.option_bits & OPTION_GTID_BEGIN)
+    is_transactional= 1;
+  /* Changes to non-transactional tables are checked for at commit */
+  if (!is_transactional)
+    DBUG_VOID_RETURN;
+
+  for (uint i= 0; i < table->s->keys; i++)
+  {
+    KEY *key= table->key_info + i;
+    KEY_PART_INFO *key_part= key->key_part;
+    KEY_PART_INFO *key_part_end= key_part + key->user_defined_key_parts;
+    ulong nr1= 1, nr2= 4;
+    ulonglong hash;
+
+    if (!(key->flags & HA_NOSAME))
+      continue;
+
+    my_charset_bin.coll->hash_sort(&my_charset_bin,
+                                   (uchar*) table->s->table_cache_key.str,
+                                   table->s->table_cache_key.length,
+                                   &nr1, &nr2);
+    my_charset_bin.coll->hash_sort(&my_charset_bin, (uchar*) &i, sizeof(i),
+                                   &nr1, &nr2);
+    for (; key_part < key_part_end; key_part++)
+    {
+      Field *field= key_part->field;
+      if ((key_part->key_part_flag & HA_PART_KEY_SEG) ||
+          (cols && !bitmap_is_set(cols, field->field_index)))
+      {
+        /* The value we have is not the one the key compares */
+        cache_mngr->writeset_unsafe= TRUE;
+        DBUG_VOID_RETURN;
+      }
+      if (field->is_null(ptrdiff))
+        break;
+      field->move_field_offset(ptrdiff);
+      field->hash(&nr1, &nr2);
+      field->move_field_offset(-ptrdiff);
+    }
+    /* Rows with NULL in a unique key do not conflict on that key */
+    if (key_part < key_part_end)
+      continue;
+
+    hash= ((ulonglong) nr1 << 32) ^ (ulonglong) nr2;
+    if (insert_dynamic(&cache_mngr->writeset, (uchar*) &hash))
+    {
+      cache_mngr->writeset_unsafe= TRUE;
+      DBUG_VOID_RETURN;
+    }
+    found_key= TRUE;
+  }
+
+  if (!found_key ||
+      cache_mngr->writeset.elements > BINLOG_WRITESET_MAX_KEYS)
+    cache_mngr->writeset_unsafe= TRUE;
+  DBUG_VOID_RETURN;
+}
+
 /**
   This function retrieves a pending row event from a cache which is
   specified through the parameter @c is_transactional. Respectively, when it
@@ -5895,6 +6221,9 @@ MYSQL_BIN_LOG::write_gtid_event(THD *thd, bool standalone,
 
   DBUG_ASSERT(local_server_id != 0);
 
+  if (this == &mysql_bin_log)
+    write_gtid_index_entry(my_b_write_tell(&log_file));
+
   if (thd->variables.option_bits & OPTION_GTID_BEGIN)
   {
     DBUG_PRINT("error", ("OPTION_GTID_BEGIN is set. "
@@ -6048,6 +6377,356 @@ MYSQL_BIN_LOG::read_state_from_file()
 }
 
 
+/* Magic number at the start of a binlog GTID index file. */
+static const uchar binlog_gtid_index_magic[]= { 0xfe, 'G', 'I', 'D', 'X', 1 };
+#define BINLOG_GTID_INDEX_HEADER_LEN 12
+#define BINLOG_GTID_INDEX_GTID_LEN 16
+
+void
+binlog_gtid_index_name(char *buf, const char *log_name)
+{
+  strxnmov(buf, FN_REFLEN - 1, log_name, ".idx", NullS);
+}
+
+
+void
+delete_binlog_gtid_index(const char *log_name)
+{
+  char name[FN_REFLEN];
+  binlog_gtid_index_name(name, log_name);
+  mysql_file_delete(key_file_binlog_gtid_index, name, MYF(0));
+}
+
+
+void
+MYSQL_BIN_LOG::open_gtid_index(my_off_t offset)
+{
+  mysql_mutex_assert_owner(&LOCK_log);
+  close_gtid_index();
+  /* A binlog file name can be reused after RESET MASTER. */
+  delete_binlog_gtid_index(log_file_name);
+  gtid_index_last_offset= offset;
+  gtid_index_failed= false;
+}
+
+
+void
+MYSQL_BIN_LOG::close_gtid_index()
+{
+  if (gtid_index_file >= 0)
+  {
+    mysql_file_close(gtid_index_file, MYF(0));
+    gtid_index_file= -1;
+  }
+}
+
+
+/*
+  Add the event group starting at offset to the GTID index of the binlog
+  file, if binlog_gtid_index_span bytes were written since the last entry.
+
+  The index file is created at the first entry, and is not synced: it is
+  deleted when the binlog file needs crash recovery. If it cannot be
+  written, it is deleted and we do not index the rest of the file.
+*/
+
+void
+MYSQL_BIN_LOG::write_gtid_index_entry(my_off_t offset)
+{
+  uchar *buf, *p;
+  rpl_gtid *list;
+  uint32 count, i;
+  size_t len;
+  mysql_mutex_assert_owner(&LOCK_log);
+
+  if (gtid_index_failed || !opt_binlog_gtid_index_span ||
+      offset < gtid_index_last_offset + opt_binlog_gtid_index_span)
+    return;
+  gtid_index_last_offset= offset;
+
+  if (gtid_index_file < 0)
+  {
+    char name[FN_REFLEN];
+    binlog_gtid_index_name(name, log_file_name);
+    if ((gtid_index_file= mysql_file_create(key_file_binlog_gtid_index, name,
+                                            0, O_WRONLY | O_TRUNC | O_BINARY,
+                                            MYF(MY_WME))) < 0 ||
+        mysql_file_write(gtid_index_file, binlog_gtid_index_magic,
+                         sizeof(binlog_gtid_index_magic),
+                         MYF(MY_WME | MY_NABP)))
+      goto err;
+  }
+
+  count= rpl_global_gtid_binlog_state.count();
+  len= BINLOG_GTID_INDEX_HEADER_LEN + count * BINLOG_GTID_INDEX_GTID_LEN;
+  if (!(buf= (uchar *) my_malloc(ALIGN_SIZE(len) + count * sizeof(rpl_gtid),
+                                 MYF(MY_WME))))
+    goto err;
+  list= (rpl_gtid *) (buf + ALIGN_SIZE(len));
+  if (rpl_global_gtid_binlog_state.get_gtid_list(list, count))
+  {
+    /* Should not happen with LOCK_log held; just skip this entry. */
+    my_free(buf);
+    return;
+  }
+  int8store(buf, offset);
+  int4store(buf + 8, count);
+  for (i= 0, p= buf + BINLOG_GTID_INDEX_HEADER_LEN; i < count;
+       i++, p+= BINLOG_GTID_INDEX_GTID_LEN)
+  {
+    int4store(p, list[i].domain_id);
+    int4store(p + 4, list[i].server_id);
+    int8store(p + 8, list[i].seq_no);
+  }
+  if (mysql_file_write(gtid_index_file, buf, len, MYF(MY_WME | MY_NABP)))
+  {
+    my_free(buf);
+    goto err;
+  }
+  my_free(buf);
+  return;
+
+err:
+  sql_print_warning("Failed to write the GTID index of binlog file '%s'; "
+                    "the rest of the file will not be indexed",
+                    log_file_name);
+  close_gtid_index();
+  delete_binlog_gtid_index(log_file_name);
+  gtid_index_failed= true;
+}
+
+
+/*
+  Read the GTID index of a binlog file, up to the first entry beyond
+  max_offset (or the first incomplete entry, if the file is still being
+  written).
+
+  Returns true if the binlog file has no usable index.
+*/
+
+bool
+Binlog_gtid_index::read(const char *log_name, my_off_t max_offset)
+{
+  char name[FN_REFLEN];
+  File file;
+  uchar *buf, *p, *end;
+  size_t len;
+  uint i, j, num_entries= 0, num_gtids= 0;
+  my_off_t prev_offset= 0;
+  bool res= true;
+
+  binlog_gtid_index_name(name, log_name);
+  if ((file= mysql_file_open(key_file_binlog_gtid_index, name,
+                             O_RDONLY | O_BINARY, MYF(0))) < 0)
+    return true;
+  len= (size_t) mysql_file_seek(file, 0L, MY_SEEK_END, MYF(0));
+  if (len == (size_t) MY_FILEPOS_ERROR ||
+      len < sizeof(binlog_gtid_index_magic) ||
+      !(buf= (uchar *) my_malloc(len, MYF(0))))
+    goto end_close;
+  if (mysql_file_pread(file, buf, len, 0, MYF(MY_NABP)) ||
+      memcmp(buf, binlog_gtid_index_magic, sizeof(binlog_gtid_index_magic)))
+    goto end_free;
+
+  /* Count the complete entries, then copy them out. */
+  end= buf + len;
+  for (p= buf + sizeof(binlog_gtid_index_magic);
+       p + BINLOG_GTID_INDEX_HEADER_LEN <= end; )
+  {
+    my_off_t offset= uint8korr(p);
+    uint32 gtid_count= uint4korr(p + 8);
+    if (offset <= prev_offset || offset > max_offset ||
+        (size_t) (end - p - BINLOG_GTID_INDEX_HEADER_LEN) <
+        (size_t) gtid_count * BINLOG_GTID_INDEX_GTID_LEN)
+      break;
+    prev_offset= offset;
+    num_entries++;
+    num_gtids+= gtid_count;
+    p+= BINLOG_GTID_INDEX_HEADER_LEN + gtid_count * BINLOG_GTID_INDEX_GTID_LEN;
+  }
+  if (!num_entries ||
+      !(entries= (entry *) my_malloc(num_entries * sizeof(entry), MYF(0))) ||
+      !(gtids= (rpl_gtid *) my_malloc((num_gtids + 1) * sizeof(rpl_gtid),
+                                      MYF(0))))
+    goto end_free;
+
+  p= buf + sizeof(binlog_gtid_index_magic);
+  num_gtids= 0;
+  for (i= 0; i < num_entries; i++)
+  {
+    entries[i].offset= uint8korr(p);
+    entries[i].count= uint4korr(p + 8);
+    entries[i].list= gtids + num_gtids;
+    p+= BINLOG_GTID_INDEX_HEADER_LEN;
+    for (j= 0; j < entries[i].count; j++, p+= BINLOG_GTID_INDEX_GTID_LEN)
+    {
+      gtids[num_gtids].domain_id= uint4korr(p);
+      gtids[num_gtids].server_id= uint4korr(p + 4);
+      gtids[num_gtids].seq_no= uint8korr(p + 8);
+      num_gtids++;
+    }
+  }
+  count= num_entries;
+  res= false;
+
+end_free:
+  my_free(buf);
+end_close:
+  mysql_file_close(file, MYF(0));
+  return res;
+}
+
+
+/* Find the last entry at or before offset, NULL if none. */
+
+Binlog_gtid_index::entry *
+Binlog_gtid_index::find(my_off_t offset)
+{
+  uint lo= 0, hi= count;
+  while (lo < hi)
+  {
+    uint mid= (lo + hi) / 2;
+    if (entries[mid].offset <= offset)
+      lo= mid + 1;
+    else
+      hi= mid;
+  }
+  return lo ? &entries[lo - 1] : NULL;
+}
+
+
+void Binlog_tail_cache::init()
+{
+  mysql_rwlock_init(key_rwlock_binlog_tail_cache, &lock);
+}
+
+
+void Binlog_tail_cache::destroy()
+{
+  mysql_rwlock_destroy(&lock);
+  my_free(buf);
+  buf= NULL;
+  size= 0;
+}
+
+
+/* Start caching a new binlog file, which is pos bytes long. */
+
+void Binlog_tail_cache::reset(const char *name, my_off_t pos)
+{
+  mysql_rwlock_wrlock(&lock);
+  strmake_buf(log_name, name);
+  start= end= pos;
+  mysql_rwlock_unlock(&lock);
+}
+
+
+/* Copy length bytes of the file, starting at from, out of the ring buffer. */
+
+void Binlog_tail_cache::copy(uchar *to, my_off_t from, size_t length)
+{
+  size_t offs= (size_t) (from % size);
+  size_t part= MY_MIN(length, size - offs);
+  memcpy(to, buf + offs, part);
+  if (part < length)
+    memcpy(to + part, buf, length - part);
+}
+
+
+/*
+  Read the bytes [end, new_end) of the current binlog file into the cache,
+  dropping the oldest bytes to make room for them. The caller must hold
+  LOCK_log or LOCK_binlog_sync, and have flushed the bytes to the file.
+
+  The bytes are read back from the file (they are still in the OS page
+  cache) rather than captured in Log_event_writer, as a number of events
+  are written directly into log_file. This is done once per binlog group,
+  instead of once per dump thread.
+*/
+
+void Binlog_tail_cache::append(File file, my_off_t new_end)
+{
+  if (!opt_binlog_tail_cache_size && !size)
+    return;
+
+  mysql_rwlock_wrlock(&lock);
+  if (size != opt_binlog_tail_cache_size)
+  {
+    /* binlog_tail_cache_size was changed, start over with an empty cache */
+    my_free(buf);
+    buf= NULL;
+    size= opt_binlog_tail_cache_size;
+    if (size && !(buf= (uchar *) my_malloc(size, MYF(0))))
+      size= 0;
+    start= end;
+  }
+
+  if (size && log_name[0] && new_end > end)
+  {
+    if (new_end - end > size)
+      start= end= new_end - size;
+    while (end < new_end)
+    {
+      size_t offs= (size_t) (end % size);
+      size_t length= (size_t) MY_MIN(new_end - end, size - offs);
+      if (mysql_file_pread(file, buf + offs, length, end, MYF(MY_NABP)))
+      {
+        /* Dump threads will read the file */
+        start= end= new_end;
+        break;
+      }
+      end+= length;
+    }
+    if (end - start > size)
+      start= end - size;
+  }
+
+  mysql_rwlock_unlock(&lock);
+}
+
+
+/*
+  Append the event at pos of binlog file name to packet, if it is in the
+  cache and ends at or before end_pos.
+
+  @retval false  the event was appended to packet
+  @retval true   the event is not in the cache, it must be read from the file
+*/
+
+bool Binlog_tail_cache::read_event(const char *name, my_off_t pos,
+                                   my_off_t end_pos, String *packet)
+{
+  uchar header[LOG_EVENT_MINIMAL_HEADER_LEN];
+  bool res= true;
+
+  if (!opt_binlog_tail_cache_size)
+    return true;
+
+  mysql_rwlock_rdlock(&lock);
+  end_pos= MY_MIN(end_pos, end);
+  if (size && pos >= start && pos + LOG_EVENT_MINIMAL_HEADER_LEN <= end_pos &&
+      !strcmp(name, log_name))
+  {
+    copy(header, pos, LOG_EVENT_MINIMAL_HEADER_LEN);
+    ulong data_len= uint4korr(header + EVENT_LEN_OFFSET);
+    if (data_len >= LOG_EVENT_MINIMAL_HEADER_LEN && pos + data_len <= end_pos)
+    {
+      size_t old_length= packet->length();
+      if (!packet->reserve(data_len))
+      {
+        copy((uchar *) packet->ptr() + old_length, pos, data_len);
+        packet->length(old_length + data_len);
+        res= false;
+      }
+    }
+  }
+  mysql_rwlock_unlock(&lock);
+
+  my_atomic_add64_explicit(res ? &misses : &hits, 1, MY_MEMORY_ORDER_RELAXED);
+  return res;
+}
+
+
 int
 MYSQL_BIN_LOG::get_most_recent_gtid_list(rpl_gtid **list, uint32 *size)
 {
@@ -6254,6 +6933,10 @@ bool MYSQL_BIN_LOG::write(Log_event *event_info, my_bool *with_annotate)
       cache_data= cache_mngr->get_binlog_cache_data(is_trans_cache);
       file= &cache_data->cache_log;
 
+      /* Only row events can be described by a writeset */
+      if (is_trans_cache)
+        cache_mngr->writeset_unsafe= TRUE;
+
       if (thd->lex->stmt_accessed_non_trans_temp_table())
         cache_data->set_changes_to_non_trans_temp_table();
 
@@ -6355,8 +7038,14 @@ bool MYSQL_BIN_LOG::write(Log_event *event_info, my_bool *with_annotate)
       {
         bool synced;
 
+        /*
+          Wait for a group commit that is still syncing the binlog, so that
+          the after_flush hooks see transactions in binlog order.
+        */
+        mysql_mutex_lock(&LOCK_binlog_sync);
         if ((error= flush_and_sync(&synced)))
         {
+          mysql_mutex_unlock(&LOCK_binlog_sync);
         }
         else
         {
@@ -6372,6 +7061,7 @@ bool MYSQL_BIN_LOG::write(Log_event *event_info, my_bool *with_annotate)
           {
             sql_print_error("Failed to run 'after_flush' hooks");
             error= 1;
+            mysql_mutex_unlock(&LOCK_binlog_sync);
           }
           else
           {
@@ -6382,6 +7072,7 @@ bool MYSQL_BIN_LOG::write(Log_event *event_info, my_bool *with_annotate)
              * it's list before dump-thread tries to send it
              */
             update_binlog_end_pos(offset);
+            mysql_mutex_unlock(&LOCK_binlog_sync);
 
             if ((error= rotate(false, &check_purge)))
               check_purge= false;
@@ -6983,18 +7674,24 @@ bool MYSQL_BIN_LOG::write_incident(THD *thd)
   if (likely(is_open()))
   {
     prev_binlog_id= current_binlog_id;
-    if (!(error= write_incident_already_locked(thd)) &&
-        !(error= flush_and_sync(0)))
+    if (!(error= write_incident_already_locked(thd)))
     {
-      signal_update();
-      if ((error= rotate(false, &check_purge)))
+      /*
+        Go through the sync stage, so that the end position is not published
+        before a group commit still syncing the binlog is done.
+      */
+      mysql_mutex_lock(&LOCK_binlog_sync);
+      if (!(error= flush_and_sync(0)))
+        signal_update();
+      update_binlog_end_pos(my_b_tell(&log_file));
+      mysql_mutex_unlock(&LOCK_binlog_sync);
+
+      if (!error && (error= rotate(false, &check_purge)))
         check_purge= false;
     }
 
     offset= my_b_tell(&log_file);
 
-    update_binlog_end_pos(offset);
-
     /*
       Take mutex to protect against a reader seeing partial writes of 64-bit
       offset on 32-bit CPUs.
@@ -7024,7 +7721,10 @@ MYSQL_BIN_LOG::write_binlog_checkpoint_event_already_locked(const char *name_arg
     Note that we must sync the binlog checkpoint to disk.
     Otherwise a subsequent log purge could delete binlogs that XA recovery
     thinks are needed (even though they are not really).
+    This goes through the sync stage, so that the end position is not
+    published before a group commit still syncing the binlog is done.
   */
+  mysql_mutex_lock(&LOCK_binlog_sync);
   if (!write_event(&ev) && !flush_and_sync(0))
   {
     signal_update();
@@ -7045,6 +7745,7 @@ MYSQL_BIN_LOG::write_binlog_checkpoint_event_already_locked(const char *name_arg
   offset= my_b_tell(&log_file);
 
   update_binlog_end_pos(offset);
+  mysql_mutex_unlock(&LOCK_binlog_sync);
 
   /*
     Take mutex to protect against a reader seeing partial writes of 64-bit
@@ -7572,6 +8273,11 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
   bool check_purge= false;
   ulong UNINIT_VAR(binlog_id);
   uint64 commit_id;
+  uint group_size= 0;
+  bool rotate_group= false;
+  bool group_synced= false;
+  mysql_mutex_t *stage_lock= &LOCK_log;
+  ulonglong flush_start, flush_end, sync_start, commit_start;
   DBUG_ENTER("MYSQL_BIN_LOG::trx_group_commit_leader");
 
   {
@@ -7612,11 +8318,13 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
       current->next= queue;
       queue= current;
       current= next;
+      ++group_size;
     }
     DBUG_ASSERT(leader == queue /* the leader should be first in queue */);
 
     /* Now we have in queue the list of transactions to be committed in order. */
   }
+  flush_start= microsecond_interval_timer();
     
   DBUG_ASSERT(is_open());
   if (likely(is_open()))                       // Should always be true
@@ -7645,6 +8353,7 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
     for (current= queue; current != NULL; current= current->next)
     {
       binlog_cache_mngr *cache_mngr= current->cache_mngr;
+      uint64 trx_commit_id= commit_id;
 
       /*
         We already checked before that at least one cache is non-empty; if both
@@ -7652,7 +8361,12 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
       */
       DBUG_ASSERT(!cache_mngr->stmt_cache.empty() || !cache_mngr->trx_cache.empty());
 
-      if ((current->error= write_transaction_or_stmt(current, commit_id)))
+      if (opt_binlog_dependency_tracking == BINLOG_DEPENDENCY_WRITESET)
+        trx_commit_id= writeset_commit_id(current, commit_id);
+      else
+        writeset_group_id= 0;
+
+      if ((current->error= write_transaction_or_stmt(current, trx_commit_id)))
         current->commit_errno= errno;
 
       strmake_buf(cache_mngr->last_commit_pos_file, log_file_name);
@@ -7679,8 +8393,10 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
       }
     }
 
-    bool synced= 0;
-    if (flush_and_sync(&synced))
+    bool need_sync= false;
+    bool flush_error= flush_for_sync(&need_sync);
+    File fd= log_file.file;
+    if (flush_error)
     {
       for (current= queue; current != NULL; current= current->next)
       {
@@ -7692,12 +8408,60 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
         }
       }
     }
-    else
+
+    /*
+      If any commit_events are Xid_log_event, increase the number of pending
+      XIDs in current binlog (it's decreased in ::unlog()). When the count in
+      a (not active) binlog file reaches zero, we know that it is no longer
+      needed in XA recovery, and we can log a new binlog checkpoint event.
+    */
+    if (xid_count > 0)
+    {
+      mark_xids_active(binlog_id, xid_count);
+    }
+
+    /*
+      The sync stage. We take LOCK_binlog_sync before releasing LOCK_log, so
+      that groups enter it in binlog order. Once we have it, the next group
+      can start writing to the binlog while we sync. A group that fills up
+      the binlog file keeps LOCK_log until it has rotated, as rotation closes
+      the file.
+    */
+    rotate_group= my_b_tell(&log_file) >= (my_off_t) max_size;
+    flush_end= microsecond_interval_timer();
+    my_atomic_add32_explicit(&sync_stage_queue, group_size,
+                             MY_MEMORY_ORDER_RELAXED);
+    DEBUG_SYNC(leader->thd, "commit_before_get_LOCK_binlog_sync");
+    mysql_mutex_lock(&LOCK_binlog_sync);
+    my_atomic_add32_explicit(&sync_stage_queue, -(int32) group_size,
+                             MY_MEMORY_ORDER_RELAXED);
+    sync_start= microsecond_interval_timer();
+    if (!rotate_group)
+    {
+      mysql_mutex_unlock(&LOCK_log);
+      stage_lock= &LOCK_binlog_sync;
+      DEBUG_SYNC(leader->thd, "commit_after_release_LOCK_log");
+    }
+
+    if (!flush_error && need_sync && sync_binlog_file(fd))
+    {
+      for (current= queue; current != NULL; current= current->next)
+      {
+        if (!current->error)
+        {
+          current->error= ER_ERROR_ON_WRITE;
+          current->commit_errno= errno;
+          current->error_cache= NULL;
+        }
+      }
+    }
+    else if (!flush_error)
     {
       bool any_error= false;
 
+      group_synced= need_sync;
       mysql_mutex_assert_not_owner(&LOCK_prepare_ordered);
-      mysql_mutex_assert_owner(&LOCK_log);
+      mysql_mutex_assert_owner(&LOCK_binlog_sync);
       mysql_mutex_assert_not_owner(&LOCK_after_binlog_sync);
       mysql_mutex_assert_not_owner(&LOCK_commit_ordered);
       bool first= true, last;
@@ -7708,7 +8472,7 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
             RUN_HOOK(binlog_storage, after_flush,
                 (current->thd,
                  current->cache_mngr->last_commit_pos_file,
-                 current->cache_mngr->last_commit_pos_offset, synced,
+                 current->cache_mngr->last_commit_pos_offset, need_sync,
                  first, last)))
         {
           current->error= ER_ERROR_ON_WRITE;
@@ -7731,51 +8495,53 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
         sql_print_error("Failed to run 'after_flush' hooks");
     }
 
-    /*
-      If any commit_events are Xid_log_event, increase the number of pending
-      XIDs in current binlog (it's decreased in ::unlog()). When the count in
-      a (not active) binlog file reaches zero, we know that it is no longer
-      needed in XA recovery, and we can log a new binlog checkpoint event.
-    */
-    if (xid_count > 0)
+    if (rotate_group)
     {
-      mark_xids_active(binlog_id, xid_count);
-    }
-
-    if (rotate(false, &check_purge))
-    {
-      /*
-        If we fail to rotate, which thread should get the error?
-        We give the error to the leader, as any my_error() thrown inside
-        rotate() will have been registered for the leader THD.
+      /* close() waits for LOCK_binlog_sync, so release it first. */
+      mysql_mutex_unlock(&LOCK_binlog_sync);
+      if (rotate(false, &check_purge))
+      {
+        /*
+          If we fail to rotate, which thread should get the error?
+          We give the error to the leader, as any my_error() thrown inside
+          rotate() will have been registered for the leader THD.
 
-        However we must not return error from here - that would cause
-        ha_commit_trans() to abort and rollback the transaction, which would
-        leave an inconsistent state with the transaction committed in the
-        binlog but rolled back in the engine.
+          However we must not return error from here - that would cause
+          ha_commit_trans() to abort and rollback the transaction, which would
+          leave an inconsistent state with the transaction committed in the
+          binlog but rolled back in the engine.
 
-        Instead set a flag so that we can return error later, from unlog(),
-        when the transaction has been safely committed in the engine.
-      */
-      leader->cache_mngr->delayed_error= true;
-      my_error(ER_ERROR_ON_WRITE, MYF(ME_NOREFRESH), name, errno);
-      check_purge= false;
+          Instead set a flag so that we can return error later, from unlog(),
+          when the transaction has been safely committed in the engine.
+        */
+        leader->cache_mngr->delayed_error= true;
+        my_error(ER_ERROR_ON_WRITE, MYF(ME_NOREFRESH), name, errno);
+        check_purge= false;
+      }
+      /* In case of binlog rotate, update the correct current binlog offset. */
+      commit_offset= my_b_write_tell(&log_file);
     }
-    /* In case of binlog rotate, update the correct current binlog offset. */
-    commit_offset= my_b_write_tell(&log_file);
   }
+  else
+    flush_end= sync_start= microsecond_interval_timer();
 
+  my_atomic_add32_explicit(&commit_stage_queue, group_size,
+                           MY_MEMORY_ORDER_RELAXED);
   DEBUG_SYNC(leader->thd, "commit_before_get_LOCK_after_binlog_sync");
   mysql_mutex_lock(&LOCK_after_binlog_sync);
+  my_atomic_add32_explicit(&commit_stage_queue, -(int32) group_size,
+                           MY_MEMORY_ORDER_RELAXED);
   /*
-    We cannot unlock LOCK_log until we have locked LOCK_after_binlog_sync;
-    otherwise scheduling could allow the next group commit to run ahead of us,
-    messing up the order of commit_ordered() calls. But as soon as
-    LOCK_after_binlog_sync is obtained, we can let the next group commit start.
+    We cannot unlock LOCK_binlog_sync (or LOCK_log, if we never released it)
+    until we have locked LOCK_after_binlog_sync; otherwise scheduling could
+    allow the next group commit to run ahead of us, messing up the order of
+    commit_ordered() calls. But as soon as LOCK_after_binlog_sync is obtained,
+    we can let the next group commit continue.
   */
-  mysql_mutex_unlock(&LOCK_log);
+  mysql_mutex_unlock(stage_lock);
+  commit_start= microsecond_interval_timer();
 
-  DEBUG_SYNC(leader->thd, "commit_after_release_LOCK_log");
+  DEBUG_SYNC(leader->thd, "commit_after_release_LOCK_binlog_sync");
 
   /*
     Loop through threads and run the binlog_sync hook
@@ -7805,6 +8571,10 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
   DEBUG_SYNC(leader->thd, "commit_before_get_LOCK_commit_ordered");
   mysql_mutex_lock(&LOCK_commit_ordered);
   last_commit_pos_offset= commit_offset;
+  flush_stage_time+= flush_end - flush_start;
+  sync_stage_time+= commit_start - sync_start;
+  if (group_synced)
+    ++sync_stage_syncs;
 
   /*
     Unlock LOCK_after_binlog_sync only *after* LOCK_commit_ordered has been
@@ -7837,6 +8607,7 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
     */
     last_in_queue->check_purge= check_purge;
     last_in_queue->binlog_id= binlog_id;
+    commit_stage_time+= microsecond_interval_timer() - commit_start;
 
     /* Note that we return with LOCK_commit_ordered locked! */
     DBUG_VOID_RETURN;
@@ -7873,6 +8644,7 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
     current= next;
   }
   DEBUG_SYNC(leader->thd, "commit_after_group_run_commit_ordered");
+  commit_stage_time+= microsecond_interval_timer() - commit_start;
   mysql_mutex_unlock(&LOCK_commit_ordered);
   DEBUG_SYNC(leader->thd, "commit_after_group_release_commit_ordered");
 
@@ -7883,6 +8655,78 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
 }
 
 
+/**
+  Choose the commit id of a transaction for binlog_dependency_tracking=WRITESET.
+
+  The transaction joins the current writeset group if none of the keys it
+  modified were modified by another transaction of the group. Otherwise it
+  starts a new group. Transactions without a usable writeset keep the
+  commit id from group commit and end the writeset group.
+
+  @param entry      Transaction to be written
+  @param commit_id  Commit id assigned by group commit, 0 if none
+
+  @return Commit id to write in the GTID event of the transaction
+*/
+
+uint64
+MYSQL_BIN_LOG::writeset_commit_id(group_commit_entry *entry, uint64 commit_id)
+{
+  binlog_cache_mngr *mngr= entry->cache_mngr;
+  DYNAMIC_ARRAY *writeset= &mngr->writeset;
+  uint i;
+  DBUG_ENTER("MYSQL_BIN_LOG::writeset_commit_id");
+  mysql_mutex_assert_owner(&LOCK_log);
+
+  if (mngr->writeset_unsafe || !writeset->elements ||
+      !entry->using_trx_cache || mngr->trx_cache.empty() ||
+      (entry->using_stmt_cache && !mngr->stmt_cache.empty()))
+  {
+    writeset_group_id= 0;
+    DBUG_RETURN(commit_id);
+  }
+
+  if (writeset_group_id &&
+      writeset_group.records + writeset->elements <= BINLOG_WRITESET_MAX_KEYS)
+  {
+    for (i= 0; i < writeset->elements; i++)
+    {
+      if (my_hash_search(&writeset_group,
+                         dynamic_array_ptr(writeset, i), sizeof(ulonglong)))
+        break;
+    }
+    if (i == writeset->elements)
+      goto add_keys;
+  }
+
+  /*
+    Start a new group. Group commit uses the query id of the leader as
+    commit id, so take a fresh query id to never clash with one of those.
+  */
+  my_hash_reset(&writeset_group);
+  free_root(&writeset_root, MYF(MY_MARK_BLOCKS_FREE));
+  writeset_group_id= (uint64) next_query_id();
+
+add_keys:
+  for (i= 0; i < writeset->elements; i++)
+  {
+    uchar *key= (uchar*) memdup_root(&writeset_root,
+                                     dynamic_array_ptr(writeset, i),
+                                     sizeof(ulonglong));
+    /* Duplicates within the transaction are refused, which is fine */
+    if (!key || (my_hash_insert(&writeset_group, key) &&
+                 !my_hash_search(&writeset_group, key, sizeof(ulonglong))))
+    {
+      /* Out of memory; let no later transaction join this group */
+      commit_id= writeset_group_id;
+      writeset_group_id= 0;
+      DBUG_RETURN(commit_id);
+    }
+  }
+  DBUG_RETURN(writeset_group_id);
+}
+
+
 int
 MYSQL_BIN_LOG::write_transaction_or_stmt(group_commit_entry *entry,
                                          uint64 commit_id)
@@ -7914,7 +8758,21 @@ MYSQL_BIN_LOG::write_transaction_or_stmt(group_commit_entry *entry,
                       DBUG_SUICIDE();
                     });
 
-    if (write_cache(entry->thd, mngr->get_binlog_cache_log(TRUE)))
+    if (mngr->trx_payload &&
+        mngr->trx_payload_checksum == binlog_checksum_options)
+    {
+      Transaction_payload_log_event ev(entry->thd, mngr->trx_payload,
+                                       mngr->trx_payload_len,
+                                       mngr->trx_payload_uncompressed_len);
+      if (write_event(&ev))
+      {
+        entry->error_cache= NULL;
+        DBUG_RETURN(ER_ERROR_ON_WRITE);
+      }
+      status_var_add(entry->thd->status_var.binlog_bytes_written,
+                     ev.data_written);
+    }
+    else if (write_cache(entry->thd, mngr->get_binlog_cache_log(TRUE)))
     {
       entry->error_cache= &mngr->trx_cache.cache_log;
       DBUG_RETURN(ER_ERROR_ON_WRITE);
@@ -8176,6 +9034,16 @@ void MYSQL_BIN_LOG::close(uint exiting)
 
   if (log_state == LOG_OPENED)
   {
+    /*
+      A group commit may still be syncing the file after releasing LOCK_log.
+      Let it finish before we close the file; no new group commit can start
+      its sync while we hold LOCK_log.
+    */
+    if (!is_relay_log)
+    {
+      mysql_mutex_lock(&LOCK_binlog_sync);
+      mysql_mutex_unlock(&LOCK_binlog_sync);
+    }
 #ifdef HAVE_REPLICATION
     if (log_type == LOG_BIN &&
 	(exiting & LOG_CLOSE_STOP_EVENT))
@@ -8229,6 +9097,9 @@ void MYSQL_BIN_LOG::close(uint exiting)
       mysql_file_seek(log_file.file, org_position, MY_SEEK_SET, MYF(0));
     }
 
+    close_gtid_index();
+    if (!is_relay_log)
+      tail_cache.reset("", 0);
     /* this will cleanup IO_CACHE, sync and close the file */
     MYSQL_LOG::close(exiting);
   }
@@ -10035,6 +10906,8 @@ MYSQL_BIN_LOG::do_binlog_recovery(const char *opt_name, bool do_xa_recovery)
     if (ev->flags & LOG_EVENT_BINLOG_IN_USE_F)
     {
       sql_print_information("Recovering after a crash using %s", opt_name);
+      /* The GTID index is not synced, so it may not match the binlog. */
+      delete_binlog_gtid_index(log_name);
       error= recover(&log_info, log_name, &log,
                      (Format_description_log_event *)ev, do_xa_recovery);
     }
@@ -10229,6 +11102,10 @@ TC_LOG_BINLOG::set_status_variables(THD *thd)
   mysql_mutex_lock(&LOCK_commit_ordered);
   binlog_status_var_num_commits= this->num_commits;
   binlog_status_var_num_group_commits= this->num_group_commits;
+  binlog_status_flush_stage_time= this->flush_stage_time;
+  binlog_status_sync_stage_time= this->sync_stage_time;
+  binlog_status_sync_stage_syncs= this->sync_stage_syncs;
+  binlog_status_commit_stage_time= this->commit_stage_time;
   if (!have_snapshot)
   {
     set_binlog_snapshot_file(last_commit_pos_file);
@@ -10239,7 +11116,17 @@ TC_LOG_BINLOG::set_status_variables(THD *thd)
   binlog_status_group_commit_trigger_count= this->group_commit_trigger_count;
   binlog_status_group_commit_trigger_timeout= this->group_commit_trigger_timeout;
   binlog_status_group_commit_trigger_lock_wait= this->group_commit_trigger_lock_wait;
+  binlog_status_flush_stage_queue= 0;
+  for (group_commit_entry *entry= group_commit_queue; entry;
+       entry= entry->next)
+    binlog_status_flush_stage_queue++;
   mysql_mutex_unlock(&LOCK_prepare_ordered);
+  binlog_status_sync_stage_queue=
+    my_atomic_load32_explicit(&sync_stage_queue, MY_MEMORY_ORDER_RELAXED);
+  binlog_status_commit_stage_queue=
+    my_atomic_load32_explicit(&commit_stage_queue, MY_MEMORY_ORDER_RELAXED);
+  binlog_status_tail_cache_hits= tail_cache.get_hits();
+  binlog_status_tail_cache_misses= tail_cache.get_misses();
 
   if (have_snapshot)
   {
@@ -89,11 +89,12 @@ class TC_LOG
 */
 extern mysql_mutex_t LOCK_prepare_ordered;
 extern mysql_cond_t COND_prepare_ordered;
+extern mysql_mutex_t LOCK_binlog_sync;
 extern mysql_mutex_t LOCK_after_binlog_sync;
 extern mysql_mutex_t LOCK_commit_ordered;
 #ifdef HAVE_PSI_INTERFACE
 extern PSI_mutex_key key_LOCK_prepare_ordered, key_LOCK_commit_ordered;
-extern PSI_mutex_key key_LOCK_after_binlog_sync;
+extern PSI_mutex_key key_LOCK_binlog_sync, key_LOCK_after_binlog_sync;
 extern PSI_cond_key key_COND_prepare_ordered;
 #endif
 
@@ -341,6 +342,8 @@ class MYSQL_LOG
   enum_log_type log_type;
   volatile enum_log_state log_state;
   enum cache_type io_cache_type;
+  /* Size of the log_file buffer, IO_SIZE unless set by a subclass */
+  size_t io_cache_size;
   friend class Log_event;
 #ifdef HAVE_PSI_INTERFACE
   /** Instrumentation key to use for file io in @c log_file */
@@ -414,6 +417,45 @@ class MYSQL_QUERY_LOG: public MYSQL_LOG
 #define BINLOG_COOKIE_IS_DUMMY(c) \
   ( ((ulong)(c)>>1) == BINLOG_COOKIE_DUMMY_ID )
 
+/*
+  In-memory copy of the tail of the active binlog file, shared by all dump
+  threads. The binlog writer appends everything it makes visible to dump
+  threads in MYSQL_BIN_LOG::update_binlog_end_pos(), so a dump thread that
+  keeps up with the writer reads its events from here instead of from the
+  file. The cache is a ring buffer of binlog_tail_cache_size bytes, holding
+  the bytes [start, end) of the file; a dump thread that lags behind start
+  reads the file as before.
+*/
+class Binlog_tail_cache
+{
+public:
+  Binlog_tail_cache() : buf(NULL), size(0), start(0), end(0), hits(0),
+    misses(0)
+  { log_name[0]= 0; }
+  void init();
+  void destroy();
+  void reset(const char *name, my_off_t pos);
+  void append(File file, my_off_t new_end);
+  bool read_event(const char *name, my_off_t pos, my_off_t end_pos,
+                  String *packet);
+  ulonglong get_hits()
+  { return my_atomic_load64_explicit(&hits, MY_MEMORY_ORDER_RELAXED); }
+  ulonglong get_misses()
+  { return my_atomic_load64_explicit(&misses, MY_MEMORY_ORDER_RELAXED); }
+
+private:
+  void copy(uchar *to, my_off_t from, size_t length);
+
+  /* Protects all members except the counters */
+  mysql_rwlock_t lock;
+  uchar *buf;
+  size_t size;
+  my_off_t start, end;
+  char log_name[FN_REFLEN];
+  /* Events sent from the cache, and events read from the file instead */
+  int64 hits, misses;
+};
+
 class binlog_cache_mngr;
 class binlog_cache_data;
 struct rpl_gtid;
@@ -529,6 +571,38 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   /* The reason why the group commit was grouped */
   ulonglong group_commit_trigger_count, group_commit_trigger_timeout;
   ulonglong group_commit_trigger_lock_wait;
+  /*
+    Total time in microseconds that group commits spent in each stage of
+    trx_group_commit_leader(): flush (writing to the binlog under LOCK_log),
+    sync (fsync under LOCK_binlog_sync) and commit (after_sync hooks and
+    commit_ordered()). Protected by LOCK_commit_ordered.
+  */
+  ulonglong flush_stage_time, sync_stage_time, commit_stage_time;
+  /*
+    Number of group commits that synced the binlog in the sync stage.
+    Protected by LOCK_commit_ordered.
+  */
+  ulonglong sync_stage_syncs;
+  /*
+    Number of transactions whose group commit is waiting to enter the sync
+    respectively commit stage. Updated with atomic operations.
+  */
+  int32 sync_stage_queue, commit_stage_queue;
+
+  /*
+    Writeset group, used when binlog_dependency_tracking=WRITESET.
+
+    Consecutive transactions whose writesets (hashes of the primary and
+    unique key values they modified) do not overlap are binlogged with the
+    same commit id, so that the slave can apply them in parallel even if
+    they did not group commit together. writeset_group holds the hashes of
+    all transactions in the current group; writeset_group_id is its commit
+    id, or 0 if the last binlogged transaction is not part of a group.
+    Protected by LOCK_log.
+  */
+  HASH writeset_group;
+  MEM_ROOT writeset_root;
+  uint64 writeset_group_id;
 
   /* binlog encryption data */
   struct Binlog_crypt_data crypto;
@@ -541,6 +615,15 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   uint sync_counter;
   bool state_file_deleted;
   bool binlog_state_recover_done;
+  /*
+    GTID index of the current binlog file, see write_gtid_index_entry().
+    Protected by LOCK_log.
+  */
+  File gtid_index_file;
+  my_off_t gtid_index_last_offset;
+  bool gtid_index_failed;
+  /* Tail of the current binlog file, read by dump threads */
+  Binlog_tail_cache tail_cache;
 
   inline uint get_sync_period()
   {
@@ -561,7 +644,11 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   int queue_for_group_commit(group_commit_entry *entry);
   bool write_transaction_to_binlog_events(group_commit_entry *entry);
   void trx_group_commit_leader(group_commit_entry *leader);
+  uint64 writeset_commit_id(group_commit_entry *entry, uint64 commit_id);
   bool is_xidlist_idle_nolock();
+  void open_gtid_index(my_off_t offset);
+  void close_gtid_index();
+  void write_gtid_index_entry(my_off_t offset);
 
 public:
   /*
@@ -598,6 +685,12 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
 
   /* This is relay log */
   bool is_relay_log;
+  /*
+    The relay log is only written to disk when the append buffer of
+    log_file is full, see --relay-log-in-memory. Only changed while the
+    slave threads are stopped.
+  */
+  bool relay_log_in_memory;
   ulong signal_cnt;  // update of the counter is checked by heartbeat
   enum enum_binlog_checksum_alg checksum_alg_reset; // to contain a new value when binlog is rotated
   /*
@@ -750,6 +843,16 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   bool write_event_buffer(uchar* buf,uint len);
   bool append(Log_event* ev);
   bool append_no_lock(Log_event* ev);
+  /*
+    Switch --relay-log-in-memory on or off for this relay log. The buffer
+    size only changes when the next relay log file is opened.
+  */
+  void set_relay_log_in_memory(bool in_memory);
+  /*
+    Write out the part of an in-memory relay log that is only in the append
+    buffer, so that it can be read by opening the file.
+  */
+  bool flush_relay_log_buffer();
 
   void mark_xids_active(ulong cookie, uint xid_count);
   void mark_xid_done(ulong cookie, bool write_checkpoint);
@@ -774,6 +877,20 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
      @retval other Failure
   */
   bool flush_and_sync(bool *synced);
+  /**
+     Flush binlog cache to the binary log file, and tell whether
+     'sync_binlog' asks for the file to be synchronized.
+
+     Used by group commit, which does the sync with sync_binlog_file()
+     after releasing LOCK_log.
+
+     @param[out] need_sync set to true if the file must be synchronized
+
+     @retval 0 Success
+     @retval other Failure
+  */
+  bool flush_for_sync(bool *need_sync);
+  static bool sync_binlog_file(File fd);
   int purge_logs(const char *to_log, bool included,
                  bool need_mutex, bool need_update_threads,
                  ulonglong *decrease_log_space);
@@ -832,10 +949,15 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
                                   uint64 seq_no);
 
 
+  /**
+   * called with LOCK_binlog_sync held, after the bytes up to pos have been
+   * synced, so that all writers publish the end position in binlog order
+   */
   void update_binlog_end_pos(my_off_t pos)
   {
-    mysql_mutex_assert_owner(&LOCK_log);
+    mysql_mutex_assert_owner(&LOCK_binlog_sync);
     mysql_mutex_assert_not_owner(&LOCK_binlog_end_pos);
+    tail_cache.append(log_file.file, pos);
     lock_binlog_end_pos();
     /**
      * note: it would make more sense to assert(pos > binlog_end_pos)
@@ -855,6 +977,7 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   {
     mysql_mutex_assert_owner(&LOCK_log);
     mysql_mutex_assert_not_owner(&LOCK_binlog_end_pos);
+    tail_cache.reset(file_name, pos);
     lock_binlog_end_pos();
     binlog_end_pos= pos;
     strcpy(binlog_end_pos_file, file_name);
@@ -876,6 +999,7 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   void lock_binlog_end_pos() { mysql_mutex_lock(&LOCK_binlog_end_pos); }
   void unlock_binlog_end_pos() { mysql_mutex_unlock(&LOCK_binlog_end_pos); }
   mysql_mutex_t* get_binlog_end_pos_lock() { return &LOCK_binlog_end_pos; }
+  Binlog_tail_cache *get_tail_cache() { return &tail_cache; }
 
   int wait_for_update_binlog_end_pos(THD* thd, struct timespec * timeout);
 
@@ -1062,6 +1186,12 @@ enum enum_binlog_format {
   BINLOG_FORMAT_UNSPEC=3  ///< thd_binlog_format() returns it when binlog is closed
 };
 
+/* Values of @@binlog_dependency_tracking */
+enum enum_binlog_dependency_tracking {
+  BINLOG_DEPENDENCY_GROUP_COMMIT= 0, ///< commit id only from group commit
+  BINLOG_DEPENDENCY_WRITESET= 1      ///< also share commit id by writeset
+};
+
 int query_error_code(THD *thd, bool not_killed);
 uint purge_log_get_error_code(int res);
 
@@ -1091,6 +1221,37 @@ bool flush_error_log();
 File open_binlog(IO_CACHE *log, const char *log_file_name,
                  const char **errmsg);
 
+/*
+  The GTID index of a binlog file, written next to it by
+  MYSQL_BIN_LOG::write_gtid_index_entry(). Each entry is the offset of an
+  event group in the binlog file together with the binlog state at that
+  offset, as it would be written in a Gtid_list_log_event. Entries are in
+  binlog order, so they can be binary searched.
+*/
+class Binlog_gtid_index
+{
+public:
+  struct entry
+  {
+    my_off_t offset;
+    uint32 count;
+    rpl_gtid *list;
+  };
+  entry *entries;
+  uint count;
+
+  Binlog_gtid_index() : entries(NULL), count(0), gtids(NULL) {}
+  ~Binlog_gtid_index() { my_free(entries); my_free(gtids); }
+  bool read(const char *log_name, my_off_t max_offset);
+  entry *find(my_off_t offset);
+
+private:
+  rpl_gtid *gtids;
+};
+
+void binlog_gtid_index_name(char *buf, const char *log_name);
+void delete_binlog_gtid_index(const char *log_name);
+
 void make_default_log_name(char **out, const char* log_ext, bool once);
 void binlog_reset_cache(THD *thd);
 
@@ -1221,6 +1221,7 @@ const char* Log_event::get_type_str(Log_event_type type)
   case WRITE_ROWS_COMPRESSED_EVENT_V1: return "Write_rows_compressed_v1";
   case UPDATE_ROWS_COMPRESSED_EVENT_V1: return "Update_rows_compressed_v1";
   case DELETE_ROWS_COMPRESSED_EVENT_V1: return "Delete_rows_compressed_v1";
+  case TRANSACTION_PAYLOAD_EVENT: return "Transaction_payload";
 
   default: return "Unknown";				/* impossible */
   }
@@ -2080,6 +2081,9 @@ Log_event* Log_event::read_log_event(const char* buf, uint event_len,
     case GTID_LIST_EVENT:
       ev = new Gtid_list_log_event(buf, event_len, fdle);
       break;
+    case TRANSACTION_PAYLOAD_EVENT:
+      ev = new Transaction_payload_log_event(buf, event_len, fdle);
+      break;
     case CREATE_FILE_EVENT:
       ev = new Create_file_log_event(buf, event_len, fdle);
       break;
@@ -3394,10 +3398,28 @@ void free_table_map_log_event(Table_map_log_event *event)
 void Log_event::print_base64(IO_CACHE* file,
                              PRINT_EVENT_INFO* print_event_info,
                              bool more)
+{
+  DBUG_ENTER("Log_event::print_base64");
+
+  if (print_event_info->base64_output_mode != BASE64_OUTPUT_DECODE_ROWS &&
+      my_b_tell(file) == 0)
+    my_b_write_string(file, "\nBINLOG '\n");
+
+  if (rendered_base64.length())
+    my_b_write(file, (uchar*) rendered_base64.ptr(), rendered_base64.length());
+  else
+    print_base64_data(file, print_event_info, more);
+  DBUG_VOID_RETURN;
+}
+
+
+void Log_event::print_base64_data(IO_CACHE* file,
+                                  PRINT_EVENT_INFO* print_event_info,
+                                  bool more)
 {
   uchar *ptr= (uchar *)temp_buf;
   uint32 size= uint4korr(ptr + EVENT_LEN_OFFSET);
-  DBUG_ENTER("Log_event::print_base64");
+  DBUG_ENTER("Log_event::print_base64_data");
 
   size_t const tmp_str_sz= my_base64_needed_encoded_length((int) size);
   char *const tmp_str= (char *) my_malloc(tmp_str_sz, MYF(MY_WME));
@@ -3459,9 +3481,6 @@ void Log_event::print_base64(IO_CACHE* file,
 
   if (print_event_info->base64_output_mode != BASE64_OUTPUT_DECODE_ROWS)
   {
-    if (my_b_tell(file) == 0)
-      my_b_write_string(file, "\nBINLOG '\n");
-
     my_b_printf(file, "%s\n", tmp_str);
 
     if (!more)
@@ -5863,6 +5882,8 @@ Format_description_log_event(uint8 binlog_ver, const char* server_ver)
       post_header_len[WRITE_ROWS_COMPRESSED_EVENT_V1-1]=   ROWS_HEADER_LEN_V1;
       post_header_len[UPDATE_ROWS_COMPRESSED_EVENT_V1-1]=  ROWS_HEADER_LEN_V1;
       post_header_len[DELETE_ROWS_COMPRESSED_EVENT_V1-1]=  ROWS_HEADER_LEN_V1;
+      post_header_len[TRANSACTION_PAYLOAD_EVENT-1]=
+        TRANSACTION_PAYLOAD_HEADER_LEN;
 
       // Sanity-check that all post header lengths are initialized.
       int i;
@@ -8042,6 +8063,178 @@ Gtid_list_log_event::peek(const char *event_start, uint32 event_len,
 }
 
 
+/**************************************************************************
+  Transaction_payload_log_event methods
+**************************************************************************/
+
+#ifdef MYSQL_SERVER
+Transaction_payload_log_event::Transaction_payload_log_event(
+        THD *thd_arg, const uchar *payload_arg, uint32 payload_len_arg,
+        uint32 uncompressed_len_arg)
+  :Log_event(thd_arg, 0, true), events(NULL), event_count(0),
+   payload(payload_arg), payload_len(payload_len_arg),
+   uncompressed_len(uncompressed_len_arg)
+{
+  cache_type= EVENT_NO_CACHE;
+}
+
+
+bool Transaction_payload_log_event::write()
+{
+  return write_header(payload_len) ||
+         write_data(payload, payload_len) ||
+         write_footer();
+}
+#endif  /* MYSQL_SERVER */
+
+
+Transaction_payload_log_event::Transaction_payload_log_event(
+       const char *buf, uint event_len,
+       const Format_description_log_event *description_event)
+  :Log_event(buf, description_event), events(NULL), event_count(0),
+   payload(NULL), payload_len(0), uncompressed_len(0)
+{
+  uint8 header_size= description_event->common_header_len;
+  uint8 post_header_len=
+    description_event->post_header_len[TRANSACTION_PAYLOAD_EVENT-1];
+  char *data= NULL;
+  Log_event **evs= NULL;
+  uint32 pos, count, i;
+
+  if (event_len < (uint) header_size + post_header_len + 1)
+    return;
+  buf+= header_size + post_header_len;
+  payload_len= event_len - header_size - post_header_len;
+  if (!(buf[0] & 0x80))
+    return;
+  uncompressed_len= binlog_get_uncompress_len(buf);
+  if (!(data= (char *) my_malloc(uncompressed_len + 1, MYF(MY_WME))))
+    return;
+  uint32 len= uncompressed_len;
+  if (binlog_buf_uncompress(buf, data, payload_len, &len) ||
+      len != uncompressed_len)
+    goto err;
+
+  /* Check the event lengths before reading any event */
+  for (pos= 0, count= 0; pos < uncompressed_len; count++)
+  {
+    uint32 ev_len;
+    if (uncompressed_len - pos < LOG_EVENT_MINIMAL_HEADER_LEN ||
+        (ev_len= uint4korr(data + pos + EVENT_LEN_OFFSET)) <
+        LOG_EVENT_MINIMAL_HEADER_LEN ||
+        ev_len > uncompressed_len - pos)
+      goto err;
+    pos+= ev_len;
+  }
+  if (!count ||
+      !(evs= (Log_event **) my_malloc(count * sizeof(Log_event *),
+                                      MYF(MY_WME | MY_ZEROFILL))))
+    goto err;
+
+  for (pos= 0, i= 0; i < count; i++)
+  {
+    uint32 ev_len= uint4korr(data + pos + EVENT_LEN_OFFSET);
+    uint typ= (uchar) data[pos + EVENT_TYPE_OFFSET];
+    const char *error;
+    char *ev_buf;
+    /* Only events of the transaction cache can be in the payload */
+    switch (typ) {
+    case START_EVENT_V3:
+    case FORMAT_DESCRIPTION_EVENT:
+    case ROTATE_EVENT:
+    case STOP_EVENT:
+    case GTID_EVENT:
+    case GTID_LIST_EVENT:
+    case BINLOG_CHECKPOINT_EVENT:
+    case START_ENCRYPTION_EVENT:
+    case TRANSACTION_PAYLOAD_EVENT:
+      goto err_events;
+    }
+    if (!(ev_buf= (char *) my_malloc(ev_len, MYF(MY_WME))))
+      goto err_events;
+    memcpy(ev_buf, data + pos, ev_len);
+    /* The payload as a whole was checked already */
+    if (!(evs[i]= read_log_event(ev_buf, ev_len, &error, description_event,
+                                 FALSE)))
+    {
+      my_free(ev_buf);
+      goto err_events;
+    }
+    evs[i]->register_temp_buf(ev_buf, true);
+    evs[i]->log_pos= log_pos;
+    pos+= ev_len;
+  }
+  my_free(data);
+  events= evs;
+  event_count= count;
+  return;
+
+err_events:
+  for (i= 0; i < count; i++)
+    delete evs[i];
+  my_free(evs);
+err:
+  my_free(data);
+}
+
+
+Transaction_payload_log_event::~Transaction_payload_log_event()
+{
+  for (uint i= 0; i < event_count; i++)
+    delete events[i];
+  my_free(events);
+}
+
+
+#if defined(HAVE_REPLICATION) && !defined(MYSQL_CLIENT)
+void Transaction_payload_log_event::pack_info(Protocol *protocol)
+{
+  char buf[64];
+  size_t len= my_snprintf(buf, sizeof(buf), "%u events, %u bytes uncompressed",
+                          event_count, uncompressed_len);
+  protocol->store(buf, len, &my_charset_bin);
+}
+
+
+/*
+  Apply the events of the payload one after the other, like the SQL thread
+  would if they were in the relay log. The position is only updated for the
+  payload as a whole, which is always inside the transaction.
+*/
+int Transaction_payload_log_event::do_apply_event(rpl_group_info *rgi)
+{
+  for (uint i= 0; i < event_count; i++)
+  {
+    Log_event *ev= events[i];
+    Log_event_type typ= ev->get_type_code();
+    events[i]= NULL;
+    ev->thd= thd;
+    int error= ev->apply_event(rgi);
+    delete_or_keep_event_post_apply(rgi, typ, ev);
+    if (error)
+      return error;
+  }
+  return 0;
+}
+#endif  /* HAVE_REPLICATION && !MYSQL_CLIENT */
+
+
+#ifdef MYSQL_CLIENT
+void Transaction_payload_log_event::print(FILE *file,
+                                          PRINT_EVENT_INFO *print_event_info)
+{
+  Write_on_release_cache cache(&print_event_info->head_cache, file,
+                               Write_on_release_cache::FLUSH_F);
+
+  if (print_event_info->short_form)
+    return;
+  print_header(&cache, print_event_info, FALSE);
+  my_b_printf(&cache, "\tTransaction payload %u events, %u bytes "
+              "uncompressed\n", event_count, uncompressed_len);
+}
+#endif  /* MYSQL_CLIENT */
+
+
 /**************************************************************************
 	Intvar_log_event methods
 **************************************************************************/
@@ -10159,7 +10352,7 @@ Rows_log_event::Rows_log_event(THD *thd_arg, TABLE *tbl_arg, ulong tid,
 #ifdef HAVE_REPLICATION
     , m_curr_row(NULL), m_curr_row_end(NULL),
     m_key(NULL), m_key_info(NULL), m_key_nr(0),
-    master_had_triggers(0)
+    master_had_triggers(0), m_hash_rows(NULL), m_hash_positions(NULL)
 #endif
 {
   /*
@@ -10211,7 +10404,7 @@ Rows_log_event::Rows_log_event(const char *buf, uint event_len,
 #if !defined(MYSQL_CLIENT) && defined(HAVE_REPLICATION)
     , m_curr_row(NULL), m_curr_row_end(NULL),
     m_key(NULL), m_key_info(NULL), m_key_nr(0),
-    master_had_triggers(0)
+    master_had_triggers(0), m_hash_rows(NULL), m_hash_positions(NULL)
 #endif
 {
   DBUG_ENTER("Rows_log_event::Rows_log_event(const char*,...)");
@@ -10906,6 +11099,8 @@ int Rows_log_event::do_apply_event(rpl_group_info *rgi)
     rgi->set_row_stmt_start_timestamp();
 
     THD_STAGE_INFO(thd, stage_executing);
+    if (!error && (error= hash_scan_rows(rgi)))
+      goto rows_done;
     do
     {
       /* in_use can have been set to NULL in close_tables_for_reopen */
@@ -10963,6 +11158,9 @@ int Rows_log_event::do_apply_event(rpl_group_info *rgi)
     } // row processing loop
     while (error == 0 && (m_curr_row != m_rows_end));
 
+rows_done:
+    free_hash_scan_rows();
+
     /*
       Restore the sql_mode after the rows event is processed.
     */
@@ -11748,6 +11946,15 @@ Table_map_log_event::~Table_map_log_event()
 }
 
 
+#if !defined(MYSQL_CLIENT) && defined(HAVE_REPLICATION)
+table_def *Table_map_log_event::create_table_def()
+{
+  return new table_def(m_coltype, m_colcnt, m_field_metadata,
+                       m_field_metadata_size, m_null_bits, m_flags);
+}
+#endif
+
+
 #ifdef MYSQL_CLIENT
 
 /*
@@ -12968,6 +13175,200 @@ void issue_long_find_row_warning(Log_event_type type,
 }
 
 
+/*
+  A before image of a row event, for hash_scan_rows()
+*/
+
+struct hash_scan_row
+{
+  const uchar *row;             /* Start of the before image in the event */
+  uchar *pos;                   /* Position of the row in the table, or 0 */
+  ulonglong hash;               /* Hash of the unpacked before image */
+};
+
+
+/*
+  Hash of the row in table->record[0], over all its columns.
+
+  Rows that record_compare() considers equal get the same hash.
+*/
+
+static ulonglong hash_scan_record(TABLE *table)
+{
+  ulong nr1= 1, nr2= 4;
+  for (Field **ptr= table->field; *ptr; ptr++)
+    (*ptr)->hash(&nr1, &nr2);
+  return ((ulonglong) nr1 << 32) ^ (ulonglong) nr2;
+}
+
+
+/**
+  Find the table position of all before images of the event in one
+  table scan.
+
+  find_row() has to scan the table for each row of an update or delete
+  event when the table has neither a usable key nor position-by-record
+  support. Instead, hash the before images of all rows of the event,
+  scan the table once, and remember the position of each table row that
+  matches a before image. find_row() then reads the row with rnd_pos().
+
+  A table row is assigned to at most one before image, so events that
+  change several identical rows still find one row each. Rows that are
+  not found here are searched for by find_row() as before.
+
+  @returns Error code on failure, 0 on success (including when the hash
+  scan is not used).
+*/
+
+int Rows_log_event::hash_scan_rows(rpl_group_info *rgi)
+{
+  TABLE *table= m_table;
+  handler *file= table->file;
+  DYNAMIC_ARRAY rows;
+  HASH hash;
+  MY_BITMAP *saved_read_set= table->read_set;
+  MY_BITMAP *saved_write_set= table->write_set;
+  const uchar *saved_curr_row= m_curr_row;
+  const uchar *saved_curr_row_end= m_curr_row_end;
+  ulong found= 0;
+  int error= 0;
+  DBUG_ENTER("Rows_log_event::hash_scan_rows");
+
+  if (!opt_slave_rows_hash_scan || m_key_info ||
+      (get_general_type_code() != DELETE_ROWS_EVENT &&
+       get_general_type_code() != UPDATE_ROWS_EVENT) ||
+      ((file->ha_table_flags() & HA_PRIMARY_KEY_REQUIRED_FOR_POSITION) &&
+       table->s->primary_key < MAX_KEY))
+    DBUG_RETURN(0);
+
+  if (my_init_dynamic_array(&rows, sizeof(hash_scan_row), 64, 64, MYF(0)))
+    DBUG_RETURN(0);
+  table->use_all_columns();
+
+  /* Hash the before images */
+  for (m_curr_row= m_rows_buf; m_curr_row < m_rows_end; )
+  {
+    hash_scan_row row;
+    prepare_record(table, m_width, FALSE);
+    if (unpack_current_row(rgi))
+      goto err;
+    row.row= m_curr_row;
+    row.pos= NULL;
+    row.hash= hash_scan_record(table);
+    if (insert_dynamic(&rows, (uchar*) &row))
+      goto err;
+    m_curr_row= m_curr_row_end;
+    if (get_general_type_code() == UPDATE_ROWS_EVENT)
+    {
+      if (unpack_current_row(rgi, &m_cols_ai))
+        goto err;
+      m_curr_row= m_curr_row_end;
+    }
+  }
+
+  /* A single row is found as fast by find_row() */
+  if (rows.elements < 2 ||
+      !(m_hash_positions= (uchar*) my_malloc(rows.elements * file->ref_length,
+                                             MYF(0))))
+    goto err;
+  m_hash_rows= (hash_scan_row*) rows.buffer;
+  m_hash_rows_cur= m_hash_rows;
+  m_hash_rows_end= m_hash_rows + rows.elements;
+
+  if (my_hash_init(&hash, &my_charset_bin, rows.elements,
+                   offsetof(hash_scan_row, hash), sizeof(ulonglong),
+                   NULL, NULL, 0))
+    goto err;
+  for (hash_scan_row *row= m_hash_rows; row < m_hash_rows_end; row++)
+  {
+    if (my_hash_insert(&hash, (uchar*) row))
+      goto err_hash;
+  }
+
+  /* Scan the table once, stopping when all rows are found */
+  if ((error= file->ha_rnd_init_with_error(1)))
+    goto err_hash;
+  while (found < rows.elements)
+  {
+    HASH_SEARCH_STATE state;
+    hash_scan_row *row;
+    ulonglong rec_hash;
+    bool stored= FALSE;
+
+    if ((error= file->ha_rnd_next(table->record[0])))
+    {
+      if (error == HA_ERR_RECORD_DELETED)
+        continue;
+      if (error == HA_ERR_END_OF_FILE)
+        error= 0;
+      else
+        file->print_error(error, MYF(0));
+      break;
+    }
+
+    rec_hash= hash_scan_record(table);
+    for (row= (hash_scan_row*) my_hash_first(&hash, (uchar*) &rec_hash,
+                                             sizeof(rec_hash), &state);
+         row;
+         row= (hash_scan_row*) my_hash_next(&hash, (uchar*) &rec_hash,
+                                            sizeof(rec_hash), &state))
+    {
+      if (row->pos)
+        continue;
+      if (!stored)
+      {
+        file->position(table->record[0]);
+        store_record(table, record[1]);
+        stored= TRUE;
+      }
+      m_curr_row= row->row;
+      prepare_record(table, m_width, FALSE);
+      if ((error= unpack_current_row(rgi)))
+        break;
+      if (!record_compare(table))
+      {
+        row->pos= m_hash_positions + (row - m_hash_rows) * file->ref_length;
+        memcpy(row->pos, file->ref, file->ref_length);
+        found++;
+        break;
+      }
+    }
+    if (error)
+      break;
+  }
+  file->ha_rnd_end();
+  my_hash_free(&hash);
+  table->column_bitmaps_set(saved_read_set, saved_write_set);
+  m_curr_row= saved_curr_row;
+  m_curr_row_end= saved_curr_row_end;
+  if (error)
+    free_hash_scan_rows();
+  DBUG_RETURN(error);
+
+err_hash:
+  my_hash_free(&hash);
+err:
+  /* Let find_row() search for each row */
+  m_hash_rows= NULL;
+  my_free(m_hash_positions);
+  m_hash_positions= NULL;
+  delete_dynamic(&rows);
+  table->column_bitmaps_set(saved_read_set, saved_write_set);
+  m_curr_row= saved_curr_row;
+  m_curr_row_end= saved_curr_row_end;
+  DBUG_RETURN(error);
+}
+
+
+void Rows_log_event::free_hash_scan_rows()
+{
+  my_free(m_hash_rows);
+  m_hash_rows= NULL;
+  my_free(m_hash_positions);
+  m_hash_positions= NULL;
+}
+
+
 /**
   Locate the current row in event's table.
 
@@ -13051,6 +13452,7 @@ int Rows_log_event::find_row(rpl_group_info *rgi)
         (error= table->file->ha_rnd_init_with_error(0)))
       DBUG_RETURN(error);
 
+    status_var_increment(thd->status_var.slave_rows_lookup_position);
     error= table->file->ha_rnd_pos_by_record(table->record[0]);
     if (error)
     {
@@ -13076,6 +13478,32 @@ int Rows_log_event::find_row(rpl_group_info *rgi)
    */ 
   store_record(table,record[1]);    
 
+  if (m_hash_rows)
+  {
+    /* Rows are applied in order; skip the ones done by earlier calls */
+    while (m_hash_rows_cur < m_hash_rows_end &&
+           m_hash_rows_cur->row < m_curr_row)
+      m_hash_rows_cur++;
+    if (m_hash_rows_cur < m_hash_rows_end &&
+        m_hash_rows_cur->row == m_curr_row && m_hash_rows_cur->pos)
+    {
+      DBUG_PRINT("info",("locating record using hash scan position"));
+      if (!table->file->inited &&
+          (error= table->file->ha_rnd_init_with_error(0)))
+        goto end;
+      if (!(error= table->file->ha_rnd_pos(table->record[0],
+                                           m_hash_rows_cur->pos)) &&
+          !record_compare(table))
+      {
+        status_var_increment(thd->status_var.slave_rows_lookup_hash_scan);
+        goto end;
+      }
+      /* The row was changed since the hash scan; search for it below */
+      table->file->ha_rnd_end();
+      error= 0;
+    }
+  }
+
   if (m_key_info)
   {
     DBUG_PRINT("info",("locating record using key #%u [%s] (index_read)",
@@ -13155,6 +13583,7 @@ int Rows_log_event::find_row(rpl_group_info *rgi)
       /* Unique does not have non nullable part */
       if (!(table->key_info->flags & (HA_NULL_PART_KEY)))
       {
+        status_var_increment(thd->status_var.slave_rows_lookup_index);
         error= 0;
         goto end;
       }
@@ -13175,6 +13604,7 @@ int Rows_log_event::find_row(rpl_group_info *rgi)
 
         if (!null_found)
         {
+          status_var_increment(thd->status_var.slave_rows_lookup_index);
           error= 0;
           goto end;
         }
@@ -13184,6 +13614,7 @@ int Rows_log_event::find_row(rpl_group_info *rgi)
     }
 
     is_index_scan=true;
+    status_var_increment(thd->status_var.slave_rows_lookup_index_scan);
 
     /*
       In case key is not unique, we still have to iterate over records found
@@ -13223,6 +13654,7 @@ int Rows_log_event::find_row(rpl_group_info *rgi)
     }
 
     is_table_scan= true;
+    status_var_increment(thd->status_var.slave_rows_lookup_table_scan);
 
     /* Continue until we find the right record or have made a full loop */
     do
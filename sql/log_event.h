@@ -55,6 +55,7 @@
 /* Forward declarations */
 #ifndef MYSQL_CLIENT
 class String;
+class table_def;
 #endif
 
 #define PREFIX_SQL_LOAD "SQL_LOAD-"
@@ -217,6 +218,7 @@ class String;
 #define GTID_HEADER_LEN       19
 #define GTID_LIST_HEADER_LEN   4
 #define START_ENCRYPTION_HEADER_LEN 0
+#define TRANSACTION_PAYLOAD_HEADER_LEN 0
 
 /* 
   Max number of possible extra bytes in a replication event compared to a
@@ -711,6 +713,12 @@ enum Log_event_type
   UPDATE_ROWS_COMPRESSED_EVENT = 170,
   DELETE_ROWS_COMPRESSED_EVENT = 171,
 
+  /*
+    The events of a transaction compressed together, see
+    Transaction_payload_log_event.
+  */
+  TRANSACTION_PAYLOAD_EVENT = 172,
+
   /* Add new MariaDB events here - right above this comment!  */
 
   ENUM_END_EVENT /* end marker */
@@ -1256,6 +1264,13 @@ class Log_event
                     bool is_more);
   void print_base64(IO_CACHE* file, PRINT_EVENT_INFO* print_event_info,
                     bool is_more);
+  /*
+    The part of print_base64() that follows the BINLOG statement start. It
+    does not depend on earlier events, so mysqlbinlog --decode-threads can
+    run it ahead of time into rendered_base64.
+  */
+  void print_base64_data(IO_CACHE* file, PRINT_EVENT_INFO* print_event_info,
+                         bool is_more);
 #endif /* MYSQL_SERVER */
 
   /* The following code used for Flashback */
@@ -1263,6 +1278,7 @@ class Log_event
   my_bool is_flashback;
   my_bool need_flashback_review;
   String  output_buf; // Storing the event output
+  String  rendered_base64; // Output of print_base64_data(), if done already
 #ifdef WHEN_FLASHBACK_REVIEW_READY
   String  m_review_dbname;
   String  m_review_tablename;
@@ -3518,6 +3534,69 @@ class Gtid_list_log_event: public Log_event
 };
 
 
+/**
+  @class Transaction_payload_log_event
+
+  The events of one transaction, compressed together. Written in place of
+  the contents of the transaction cache when --log-bin-compress-transactions
+  is enabled, between the GTID event and the XID (or COMMIT) event of the
+  event group.
+
+  Unlike Query_compressed_log_event and the compressed row events, small
+  events compress well as part of the whole transaction, and the payload is
+  compressed only once, at commit. Dump threads send it on as it is; it is
+  only uncompressed by the reader (the slave SQL thread, mysqlbinlog).
+
+  @section Transaction_payload_log_event_binary_format Binary Format
+
+  There is no post-header. The body is the compressed data, in the format
+  written by binlog_buf_compress(). Uncompressed, it is the events of the
+  transaction, each with the checksum of the binlog the payload was written
+  to. Their end_log_pos is relative to the start of the uncompressed data.
+
+  When read, the payload is uncompressed at once into the events array, with
+  end_log_pos of each event set to that of the payload.
+*/
+
+class Transaction_payload_log_event: public Log_event
+{
+public:
+  /* The events in the payload, when read from a log */
+  Log_event **events;
+  uint event_count;
+
+#ifdef MYSQL_SERVER
+  Transaction_payload_log_event(THD *thd_arg, const uchar *payload_arg,
+                                uint32 payload_len_arg,
+                                uint32 uncompressed_len_arg);
+#ifdef HAVE_REPLICATION
+  void pack_info(Protocol *protocol);
+#endif
+#else
+  void print(FILE *file, PRINT_EVENT_INFO *print_event_info);
+#endif
+  Transaction_payload_log_event(const char *buf, uint event_len,
+                       const Format_description_log_event *description_event);
+  ~Transaction_payload_log_event();
+  Log_event_type get_type_code() { return TRANSACTION_PAYLOAD_EVENT; }
+  int get_data_size() { return payload_len; }
+  bool is_valid() const { return events != NULL; }
+#ifdef MYSQL_SERVER
+  bool write();
+#endif
+
+private:
+  /* The compressed data, only set when writing */
+  const uchar *payload;
+  uint32 payload_len;
+  uint32 uncompressed_len;
+
+#if defined(MYSQL_SERVER) && defined(HAVE_REPLICATION)
+  virtual int do_apply_event(rpl_group_info *rgi);
+#endif
+};
+
+
 /* the classes below are for the new LOAD DATA INFILE logging */
 
 /**
@@ -4293,6 +4372,8 @@ class Table_map_log_event : public Log_event
   }
   int rewrite_db(const char* new_name, size_t new_name_len,
                  const Format_description_log_event*);
+#elif defined(HAVE_REPLICATION)
+  table_def *create_table_def();
 #endif
   ulong get_table_id() const        { return m_table_id; }
   const char *get_table_name() const { return m_tblnam; }
@@ -4462,6 +4543,8 @@ class Rows_log_event : public Log_event
   MY_BITMAP const *get_cols_ai() const { return &m_cols_ai; }
   size_t get_width() const          { return m_width; }
   ulong get_table_id() const        { return m_table_id; }
+  const uchar *get_rows_buf() const { return m_rows_buf; }
+  const uchar *get_rows_end() const { return m_rows_end; }
 
 #if defined(MYSQL_SERVER)
   /*
@@ -4604,9 +4687,18 @@ class Rows_log_event : public Log_event
   KEY      *m_key_info; /* Pointer to KEY info for m_key_nr */
   uint      m_key_nr;   /* Key number */
   bool master_had_triggers;     /* set after tables opening */
+  /*
+    Before images of the event with the table position of their row, found
+    by hash_scan_rows() in a single table scan, and the next one for
+    find_row() to use. NULL when find_row() does its own search.
+  */
+  struct hash_scan_row *m_hash_rows, *m_hash_rows_cur, *m_hash_rows_end;
+  uchar    *m_hash_positions;
 
   int find_key(); // Find a best key to use in find_row()
   int find_row(rpl_group_info *);
+  int hash_scan_rows(rpl_group_info *);
+  void free_hash_scan_rows();
   int write_row(rpl_group_info *, const bool);
   int update_sequence();
 
@@ -1225,16 +1225,50 @@ bool Protocol_text::store(double from, uint32 decimals, String *buffer)
 }
 
 
+/**
+  Store the value of an integer field without going through
+  Field::val_str() and character set conversion.
+
+  Integer columns make up most of the data in large result sets, and
+  formatting them directly with int10_to_str() avoids setting up a
+  String and checking the character set for every value.
+
+  @param field  field to store
+
+  @retval -1  field can't be sent this way, caller has to use val_str()
+  @retval  0  ok
+  @retval  1  error
+*/
+
+int Protocol_text::store_integer_field(Field *field)
+{
+  if (field->flags & ZEROFILL_FLAG)
+    return -1;
+  switch (field->type()) {
+  case MYSQL_TYPE_TINY:
+    return store_tiny(field->val_int());
+  case MYSQL_TYPE_SHORT:
+    return store_short(field->val_int());
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+    return store_long(field->val_int());
+  case MYSQL_TYPE_LONGLONG:
+    return store_longlong(field->val_int(), field->flags & UNSIGNED_FLAG);
+  default:
+    break;
+  }
+  return -1;
+}
+
+
 bool Protocol_text::store(Field *field)
 {
   if (field->is_null())
     return store_null();
-#ifndef DBUG_OFF
-  field_pos++;
-#endif
   char buff[MAX_FIELD_WIDTH];
   String str(buff,sizeof(buff), &my_charset_bin);
   CHARSET_INFO *tocs= this->thd->variables.character_set_results;
+  int res;
 #ifdef DBUG_ASSERT_EXISTS
   TABLE *table= field->table;
   my_bitmap_map *old_map= 0;
@@ -1242,12 +1276,20 @@ bool Protocol_text::store(Field *field)
     old_map= dbug_tmp_use_all_columns(table, table->read_set);
 #endif
 
-  field->val_str(&str);
+  if ((res= store_integer_field(field)) < 0)
+  {
+#ifndef DBUG_OFF
+    field_pos++;
+#endif
+    field->val_str(&str);
+  }
 #ifdef DBUG_ASSERT_EXISTS
   if (old_map)
     dbug_tmp_restore_column_map(table->read_set, old_map);
 #endif
 
+  if (res >= 0)
+    return res;
   return store_string_aux(str.ptr(), str.length(), str.charset(), tocs);
 }
 
@@ -789,7 +789,8 @@ retry_event_group(rpl_group_info *rgi, rpl_parallel_thread *rpt,
   thd->reset_killed();
 
   strmake_buf(log_name, ir->name);
-  if ((fd= open_binlog(&rlog, log_name, &errmsg)) <0)
+  if (rli->relay_log.flush_relay_log_buffer() ||
+      (fd= open_binlog(&rlog, log_name, &errmsg)) <0)
   {
     err= 1;
     goto err;
@@ -875,7 +876,8 @@ retry_event_group(rpl_group_info *rgi, rpl_parallel_thread *rpt,
             goto check_retry;
           }
       });
-      if ((fd= open_binlog(&rlog, log_name, &errmsg)) <0)
+      if (rli->relay_log.flush_relay_log_buffer() ||
+          (fd= open_binlog(&rlog, log_name, &errmsg)) <0)
       {
         err= 1;
         goto check_retry;
@@ -2176,6 +2178,9 @@ rpl_parallel::wait_for_done(THD *thd, Relay_log_info *rli)
   rpl_parallel_thread *rpt;
   uint32 i, j;
 
+  /* Nothing more is queued from here on, so the read-ahead can stop. */
+  prefetch.stop_thread();
+
   /*
     First signal all workers that they must force quit; no more events will
     be queued to complete any partial event groups executed.
@@ -2823,6 +2828,8 @@ rpl_parallel::do_event(rpl_group_info *serial_rgi, Log_event *ev,
   else
   {
     qev->rgi= e->current_group_info;
+    /* Copy it before a worker can get it, and free it. */
+    prefetch.queue_event(ev, e, e->current_sub_id);
   }
 
   /*
@@ -2,6 +2,7 @@
 #define RPL_PARALLEL_H
 
 #include "log_event.h"
+#include "rpl_prefetch.h"
 
 
 struct rpl_parallel;
@@ -353,6 +354,8 @@ struct rpl_parallel {
   HASH domain_hash;
   rpl_parallel_entry *current;
   bool sql_thread_stopping;
+  /* Reads ahead the rows of queued row events, see rpl_prefetch.h */
+  rpl_prefetch prefetch;
 
   rpl_parallel();
   ~rpl_parallel();
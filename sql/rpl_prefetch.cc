@@ -0,0 +1,514 @@
+#include "mariadb.h"
+#include "rpl_prefetch.h"
+#include "rpl_parallel.h"
+#include "rpl_rli.h"
+#include "rpl_mi.h"
+#include "rpl_utility.h"
+#include "slave.h"
+#include "sql_base.h"
+#include "key.h"
+#include "transaction.h"
+
+/*
+  Code for reading ahead the rows of row events queued for parallel
+  replication worker threads.
+*/
+
+
+static void
+free_prefetch_item(void *element)
+{
+  rpl_prefetch::queued_item *item= (rpl_prefetch::queued_item *)element;
+  delete item->tabledef;
+  my_free(item);
+}
+
+
+rpl_prefetch::rpl_prefetch() :
+  queue_first(NULL), queue_last(NULL), queued_size(0), rli(NULL), thd(NULL),
+  running(false), stop(false), hits(0), misses(0), table_hash_sub_id(0),
+  table_hash_entry(NULL)
+{
+  mysql_mutex_init(key_LOCK_slave_prefetch, &LOCK_prefetch,
+                   MY_MUTEX_INIT_SLOW);
+  mysql_cond_init(key_COND_slave_prefetch, &COND_prefetch, NULL);
+  my_hash_init(&table_hash, &my_charset_bin, 16,
+               offsetof(queued_item, table_id), sizeof(ulong),
+               NULL, free_prefetch_item, HASH_UNIQUE);
+}
+
+
+rpl_prefetch::~rpl_prefetch()
+{
+  DBUG_ASSERT(!running);
+  my_hash_free(&table_hash);
+  mysql_cond_destroy(&COND_prefetch);
+  mysql_mutex_destroy(&LOCK_prefetch);
+}
+
+
+pthread_handler_t
+handle_rpl_prefetch_thread(void *arg)
+{
+  rpl_prefetch *prefetch= (rpl_prefetch *)arg;
+
+  my_thread_init();
+  prefetch->run();
+  my_thread_end();
+  return NULL;
+}
+
+
+void
+rpl_prefetch::start_thread(Relay_log_info *rli_arg)
+{
+  pthread_t th;
+
+  if (!opt_slave_parallel_prefetch)
+    return;
+
+  mysql_mutex_lock(&LOCK_prefetch);
+  DBUG_ASSERT(!running);
+  rli= rli_arg;
+  stop= false;
+  running= true;
+  if (mysql_thread_create(key_thread_slave_prefetch, &th, &connection_attrib,
+                          handle_rpl_prefetch_thread, this))
+  {
+    /* Replication works fine without it, so just say so and go on. */
+    sql_print_warning("Slave: Failed to create the prefetch thread, rows "
+                      "will not be read ahead");
+    running= false;
+  }
+  mysql_mutex_unlock(&LOCK_prefetch);
+}
+
+
+void
+rpl_prefetch::stop_thread()
+{
+  mysql_mutex_lock(&LOCK_prefetch);
+  if (running)
+  {
+    stop= true;
+    mysql_cond_signal(&COND_prefetch);
+    if (thd)
+    {
+      /* Break out of any wait for a table lock */
+      mysql_mutex_lock(&thd->LOCK_thd_data);
+      thd->awake(KILL_CONNECTION);
+      mysql_mutex_unlock(&thd->LOCK_thd_data);
+    }
+    while (running)
+      mysql_cond_wait(&COND_prefetch, &LOCK_prefetch);
+  }
+  mysql_mutex_unlock(&LOCK_prefetch);
+}
+
+
+void
+rpl_prefetch::queue_event(Log_event *ev, rpl_parallel_entry *entry,
+                          uint64 sub_id)
+{
+  Log_event_type typ= ev->get_type_code();
+  queued_item *item;
+
+  if (!running)
+    return;
+
+  if (typ == TABLE_MAP_EVENT)
+  {
+    Table_map_log_event *map_ev= static_cast<Table_map_log_event *>(ev);
+    const char *db= map_ev->get_db_name();
+    const char *table_name= map_ev->get_table_name();
+    size_t db_len= strlen(db), table_name_len= strlen(table_name);
+    char *db_copy, *table_name_copy;
+
+    if (!my_multi_malloc(MYF(0),
+                         &item, sizeof(*item),
+                         &db_copy, db_len + 1,
+                         &table_name_copy, table_name_len + 1,
+                         NULL))
+      return;
+    memcpy(db_copy, db, db_len + 1);
+    memcpy(table_name_copy, table_name, table_name_len + 1);
+    item->db= db_copy;
+    item->table_name= table_name_copy;
+    if (!(item->tabledef= map_ev->create_table_def()))
+    {
+      my_free(item);
+      return;
+    }
+    item->map_flags= map_ev->get_flags((Table_map_log_event::flag_set) ~0);
+    item->size= sizeof(*item) + db_len + table_name_len + 2;
+    item->table_id= map_ev->get_table_id();
+  }
+  else if (LOG_EVENT_IS_WRITE_ROW(typ) || LOG_EVENT_IS_UPDATE_ROW(typ) ||
+           LOG_EVENT_IS_DELETE_ROW(typ))
+  {
+    Rows_log_event *rows_ev= static_cast<Rows_log_event *>(ev);
+    const MY_BITMAP *cols= rows_ev->get_cols();
+    const MY_BITMAP *cols_ai= rows_ev->get_cols_ai();
+    size_t rows_len= rows_ev->get_rows_end() - rows_ev->get_rows_buf();
+    uint cols_len= bitmap_buffer_size(cols->n_bits);
+    my_bitmap_map *cols_buf, *cols_ai_buf;
+    uchar *rows;
+    size_t size= sizeof(*item) + cols_len * 2 + rows_len;
+
+    mysql_mutex_lock(&LOCK_prefetch);
+    bool full= queued_size + size > opt_slave_parallel_max_queued;
+    mysql_mutex_unlock(&LOCK_prefetch);
+    if (full ||
+        !rows_ev->get_rows_buf() ||
+        !my_multi_malloc(MYF(0),
+                         &item, sizeof(*item),
+                         &cols_buf, cols_len,
+                         &cols_ai_buf, cols_len,
+                         &rows, rows_len,
+                         NULL))
+    {
+      my_atomic_add64_explicit(&misses, 1, MY_MEMORY_ORDER_RELAXED);
+      return;
+    }
+    item->tabledef= NULL;
+    item->width= (uint)rows_ev->get_width();
+    my_bitmap_init(&item->cols, cols_buf, cols->n_bits, FALSE);
+    memcpy(cols_buf, cols->bitmap, cols_len);
+    my_bitmap_init(&item->cols_ai, cols_ai_buf, cols->n_bits, FALSE);
+    if (LOG_EVENT_IS_UPDATE_ROW(typ))
+      memcpy(cols_ai_buf, cols_ai->bitmap, cols_len);
+    memcpy(rows, rows_ev->get_rows_buf(), rows_len);
+    item->rows= rows;
+    item->rows_end= rows + rows_len;
+    item->size= size;
+    item->table_id= rows_ev->get_table_id();
+    typ= rows_ev->get_general_type_code();
+  }
+  else
+    return;
+
+  item->next= NULL;
+  item->entry= entry;
+  item->sub_id= sub_id;
+  item->typ= typ;
+
+  mysql_mutex_lock(&LOCK_prefetch);
+  if (queue_last)
+    queue_last->next= item;
+  else
+  {
+    queue_first= item;
+    mysql_cond_signal(&COND_prefetch);
+  }
+  queue_last= item;
+  queued_size+= item->size;
+  mysql_mutex_unlock(&LOCK_prefetch);
+}
+
+
+/*
+  Whether the event group of an item has committed already, so that there is
+  no point in reading ahead for it any more.
+*/
+bool
+rpl_prefetch::group_committed(queued_item *item)
+{
+  rpl_parallel_entry *e= item->entry;
+  bool committed;
+
+  mysql_mutex_lock(&e->LOCK_parallel_entry);
+  committed= e->last_committed_sub_id >= item->sub_id ||
+             e->force_abort;
+  mysql_mutex_unlock(&e->LOCK_parallel_entry);
+  return committed;
+}
+
+
+/*
+  Whether a worker thread may have started to apply the event group of an
+  item. Groups can start out of order, so this can also be true for a group
+  that has not started yet; the read-ahead is then counted as a miss.
+*/
+bool
+rpl_prefetch::group_started(queued_item *item)
+{
+  rpl_parallel_entry *e= item->entry;
+  bool started;
+
+  mysql_mutex_lock(&e->LOCK_parallel_entry);
+  started= e->largest_started_sub_id >= item->sub_id ||
+           e->last_committed_sub_id >= item->sub_id ||
+           e->force_abort;
+  mysql_mutex_unlock(&e->LOCK_parallel_entry);
+  return started;
+}
+
+void
+rpl_prefetch::add_table_map(queued_item *item)
+{
+  /*
+    The master logs a Table_map event for every table used in every event
+    group, so only the maps of the current group are ever needed.
+  */
+  if (item->entry != table_hash_entry || item->sub_id != table_hash_sub_id)
+  {
+    my_hash_reset(&table_hash);
+    table_hash_entry= item->entry;
+    table_hash_sub_id= item->sub_id;
+  }
+  else if (uchar *old= my_hash_search(&table_hash, (uchar *)&item->table_id,
+                                      sizeof(item->table_id)))
+    my_hash_delete(&table_hash, old);
+  if (my_hash_insert(&table_hash, (uchar *)item))
+    free_prefetch_item(item);
+}
+
+
+/*
+  Read the primary key columns of a row image into table->record[0], and skip
+  the other columns.
+
+  @return The end of the row image, or NULL if it is corrupt. *key_parts is
+          set to the number of key columns read.
+*/
+static const uchar *
+unpack_key_columns(TABLE *table, const table_def *tabledef,
+                   const MY_BITMAP *cols, uint width,
+                   const uchar *row, const uchar *rows_end, uint *key_parts)
+{
+  const uchar *null_ptr= row;
+  const uchar *pack_ptr= row + (bitmap_bits_set(cols) + 7) / 8;
+  uint null_idx= 0;
+
+  *key_parts= 0;
+  if (pack_ptr > rows_end)
+    return NULL;
+  for (uint i= 0; i < width; i++)
+  {
+    if (!bitmap_is_set(cols, i))
+      continue;
+    if (i >= tabledef->size())
+      return NULL;
+    bool is_null= null_ptr[null_idx / 8] & (1U << (null_idx % 8));
+    null_idx++;
+    if (is_null)
+      continue;
+
+    Field *field= i < table->s->fields ? table->field[i] : NULL;
+    if (field && (field->flags & PRI_KEY_FLAG))
+    {
+      if (!(pack_ptr= field->unpack(field->ptr, pack_ptr, rows_end,
+                                    tabledef->field_metadata(i))))
+        return NULL;
+      field->set_notnull();
+      (*key_parts)++;
+    }
+    else
+      pack_ptr+= tabledef->calc_field_size(i, (uchar *)pack_ptr);
+    if (pack_ptr > rows_end)
+      return NULL;
+  }
+  return pack_ptr;
+}
+
+
+/*
+  Whether the primary key columns of the table on the master can be unpacked
+  directly into the table on the slave.
+*/
+static bool
+key_columns_match(TABLE *table, const table_def *tabledef, uint16 map_flags,
+                  Relay_log_info *rli)
+{
+  KEY *key_info= table->key_info + table->s->primary_key;
+
+  for (uint i= 0; i < key_info->user_defined_key_parts; i++)
+  {
+    Field *field= key_info->key_part[i].field;
+    uint idx= field->field_index;
+    int order;
+
+    if (idx >= tabledef->size() ||
+        field->binlog_type() == MYSQL_TYPE_VARCHAR_COMPRESSED ||
+        field->binlog_type() == MYSQL_TYPE_BLOB_COMPRESSED ||
+        tabledef->type(idx) != field->real_type())
+      return false;
+    uint16 metadata= tabledef->field_metadata(idx);
+    if (metadata &&
+        (!field->compatible_field_size(metadata, rli, map_flags, &order) ||
+         order != 0))
+      return false;
+  }
+  return true;
+}
+
+
+void
+rpl_prefetch::prefetch_rows(queued_item *item)
+{
+  queued_item *map;
+  TABLE_LIST tlist, *tables= &tlist;
+  TABLE *table;
+  KEY *key_info;
+  uchar key_buf[MAX_KEY_LENGTH];
+  const uchar *row;
+  uint key_parts, counter;
+  ulong lookups= 0;
+
+  if (item->entry != table_hash_entry || item->sub_id != table_hash_sub_id ||
+      !(map= (queued_item *)my_hash_search(&table_hash,
+                                           (uchar *)&item->table_id,
+                                           sizeof(item->table_id))) ||
+      group_committed(item))
+    goto miss;
+
+  thd->reset_for_next_command();
+  tlist.init_one_table(map->db, strlen(map->db), map->table_name,
+                       strlen(map->table_name), NULL, TL_READ);
+  /*
+    Filtered out, or not there yet, the worker will find out. Tables that
+    are not transactional are never read ahead: a table lock for reading
+    would block the worker that is about to write to the table.
+  */
+  if (open_tables(thd, &tables, &counter, 0) ||
+      !(table= tlist.table) ||
+      !table->file->has_transactions() ||
+      lock_tables(thd, &tlist, counter, 0))
+    goto end;
+
+  if (table->s->primary_key == MAX_KEY ||
+      !key_columns_match(table, map->tabledef, map->map_flags, rli) ||
+      table->file->ha_index_init(table->s->primary_key, 0))
+    goto end;
+
+  key_info= table->key_info + table->s->primary_key;
+  bitmap_set_all(table->read_set);
+  for (row= item->rows; row < item->rows_end; )
+  {
+    row= unpack_key_columns(table, map->tabledef, &item->cols, item->width,
+                            row, item->rows_end, &key_parts);
+    if (!row)
+      break;
+    if (key_parts == key_info->user_defined_key_parts)
+    {
+      key_copy(key_buf, table->record[0], key_info, 0);
+      int error= table->file->ha_index_read_map(table->record[1], key_buf,
+                                                HA_WHOLE_KEY,
+                                                HA_READ_KEY_EXACT);
+      /* A row that is not there yet, as for an insert, still reads the page */
+      if (!error || error == HA_ERR_KEY_NOT_FOUND ||
+          error == HA_ERR_END_OF_FILE)
+        lookups++;
+    }
+    /* Skip the after image of an update */
+    if (item->typ == UPDATE_ROWS_EVENT &&
+        !(row= unpack_key_columns(table, map->tabledef, &item->cols_ai,
+                                  item->width, row, item->rows_end,
+                                  &key_parts)))
+      break;
+    if (unlikely(thd->killed))
+      break;
+  }
+  table->file->ha_index_end();
+
+end:
+  thd->clear_error();
+  ha_commit_trans(thd, FALSE);
+  ha_commit_trans(thd, TRUE);
+  close_thread_tables(thd);
+  thd->mdl_context.release_transactional_locks();
+  free_root(thd->mem_root, MYF(MY_KEEP_PREALLOC));
+
+  /* Only a hit if the rows were read before the worker needed them */
+  if (lookups && !group_started(item))
+  {
+    my_atomic_add64_explicit(&hits, 1, MY_MEMORY_ORDER_RELAXED);
+    return;
+  }
+miss:
+  my_atomic_add64_explicit(&misses, 1, MY_MEMORY_ORDER_RELAXED);
+}
+
+void
+rpl_prefetch::run()
+{
+  THD *new_thd;
+  queued_item *items, *next;
+
+  new_thd= new THD(next_thread_id());
+  new_thd->thread_stack= (char*)&new_thd;
+  add_to_active_threads(new_thd);
+  set_current_thd(new_thd);
+  new_thd->init_for_queries();
+  init_thr_lock();
+  new_thd->store_globals();
+  /* Not a slave thread, it never applies anything */
+  new_thd->system_thread= SYSTEM_THREAD_GENERIC;
+  new_thd->security_ctx->skip_grants();
+  thd_proc_info(new_thd, "Reading ahead rows of queued events");
+  /* Never lock or wait for rows, and do not wait long behind DDL */
+  new_thd->variables.tx_isolation= ISO_READ_UNCOMMITTED;
+  new_thd->variables.lock_wait_timeout= 1;
+
+  mysql_mutex_lock(&LOCK_prefetch);
+  thd= new_thd;
+  for (;;)
+  {
+    while (!stop && !queue_first)
+      mysql_cond_wait(&COND_prefetch, &LOCK_prefetch);
+    if (stop)
+      break;
+    items= queue_first;
+    queue_first= queue_last= NULL;
+    mysql_mutex_unlock(&LOCK_prefetch);
+
+    for (; items; items= next)
+    {
+      size_t size= items->size;
+      next= items->next;
+      if (items->typ == TABLE_MAP_EVENT)
+        add_table_map(items);
+      else
+      {
+        if (!new_thd->killed)
+          prefetch_rows(items);
+        else
+          my_atomic_add64_explicit(&misses, 1, MY_MEMORY_ORDER_RELAXED);
+        free_prefetch_item(items);
+      }
+      mysql_mutex_lock(&LOCK_prefetch);
+      queued_size-= size;
+      mysql_mutex_unlock(&LOCK_prefetch);
+    }
+
+    mysql_mutex_lock(&LOCK_prefetch);
+  }
+
+  /* Discard what is left, and free the table maps */
+  for (items= queue_first; items; items= next)
+  {
+    next= items->next;
+    if (items->typ != TABLE_MAP_EVENT)
+      my_atomic_add64_explicit(&misses, 1, MY_MEMORY_ORDER_RELAXED);
+    free_prefetch_item(items);
+  }
+  queue_first= queue_last= NULL;
+  queued_size= 0;
+  my_hash_reset(&table_hash);
+  table_hash_entry= NULL;
+  thd= NULL;
+  mysql_mutex_unlock(&LOCK_prefetch);
+
+  new_thd->clear_error();
+  new_thd->catalog= 0;
+  new_thd->reset_query();
+  new_thd->reset_db(NULL, 0);
+  THD_CHECK_SENTRY(new_thd);
+  unlink_not_visible_thd(new_thd);
+  delete new_thd;
+
+  mysql_mutex_lock(&LOCK_prefetch);
+  running= false;
+  mysql_cond_broadcast(&COND_prefetch);
+  mysql_mutex_unlock(&LOCK_prefetch);
+}
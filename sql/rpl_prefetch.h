@@ -0,0 +1,95 @@
+#ifndef RPL_PREFETCH_H
+#define RPL_PREFETCH_H
+
+#include "log_event.h"
+
+
+struct rpl_parallel_entry;
+class Relay_log_info;
+
+
+/*
+  Read-ahead of the rows changed by row events in parallel replication
+  (--slave-parallel-prefetch).
+
+  The SQL driver thread usually reads the relay log well ahead of the worker
+  threads. For every Table_map and row event it queues for a worker, it also
+  queues a copy of the event data here. A separate prefetch thread then looks
+  up each row by primary key, without locking it, so that the pages the
+  worker will need are already in the buffer pool when the worker gets to
+  the event. The lookup only needs to read the page; the row itself is thrown
+  away.
+
+  Only transactional tables with a primary key are prefetched, and only if
+  the key columns have the same type on master and slave. Rows of event
+  groups that are already committed when the prefetch thread gets to them
+  are skipped.
+*/
+struct rpl_prefetch {
+  struct queued_item {
+    queued_item *next;
+    rpl_parallel_entry *entry;
+    /* The sub_id of the event group of the event */
+    uint64 sub_id;
+    size_t size;
+    /* TABLE_MAP_EVENT, or the general type code of a row event */
+    Log_event_type typ;
+    ulong table_id;
+
+    /* For TABLE_MAP_EVENT */
+    char *db, *table_name;
+    table_def *tabledef;
+    uint16 map_flags;
+
+    /* For row events */
+    uint width;
+    MY_BITMAP cols, cols_ai;
+    uchar *rows, *rows_end;
+  };
+
+  mysql_mutex_t LOCK_prefetch;
+  mysql_cond_t COND_prefetch;
+  queued_item *queue_first, *queue_last;
+  /* Total size of queued items, limited by --slave-parallel-max-queued */
+  size_t queued_size;
+  Relay_log_info *rli;
+  THD *thd;
+  bool running;
+  bool stop;
+
+  /*
+    Row events whose rows were looked up before a worker thread started on
+    their event group, and all other row events: those that were not read
+    ahead because the queue was full, the table could not be read ahead, or
+    the worker threads got there first. Updated with atomic operations by the
+    prefetch thread, and by the SQL driver thread in queue_event(). Shown in
+    SHOW ALL SLAVES STATUS.
+  */
+  int64 hits, misses;
+
+  rpl_prefetch();
+  ~rpl_prefetch();
+  /* Start the prefetch thread, if --slave-parallel-prefetch is enabled. */
+  void start_thread(Relay_log_info *rli);
+  /* Stop the prefetch thread and discard everything queued. */
+  void stop_thread();
+  /*
+    Queue a copy of a Table_map or row event, which is about to be queued
+    for the event group with sub_id in entry. Other events are ignored.
+  */
+  void queue_event(Log_event *ev, rpl_parallel_entry *entry, uint64 sub_id);
+  void run();
+
+private:
+  HASH table_hash;
+  /* The event group that the Table_map items in table_hash belong to */
+  uint64 table_hash_sub_id;
+  rpl_parallel_entry *table_hash_entry;
+
+  void add_table_map(queued_item *item);
+  void prefetch_rows(queued_item *item);
+  bool group_committed(queued_item *item);
+  bool group_started(queued_item *item);
+};
+
+#endif  /* RPL_PREFETCH_H */
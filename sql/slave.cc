@@ -1220,6 +1220,14 @@ int start_slave_threads(THD *thd,
     lock_cond_sql = &mi->rli.run_lock;
   }
 
+  /*
+    --relay-log-in-memory relies on the relay logs being purged below when
+    the threads start again, so it is only used with GTID.
+  */
+  if (!mi->slave_running && !mi->rli.slave_running)
+    mi->rli.relay_log.set_relay_log_in_memory(
+      opt_relay_log_in_memory && mi->using_gtid != Master_info::USE_GTID_NO);
+
   /*
     If we are using GTID and both SQL and IO threads are stopped, then get
     rid of all relay logs.
@@ -3056,6 +3064,14 @@ void show_master_info_get_fields(THD *thd, List<Item> *field_list,
                           Item_empty_string(thd, "Gtid_Slave_Pos",
                                             gtid_pos_length),
                           mem_root);
+    field_list->push_back(new (mem_root)
+                          Item_return_int(thd, "Slave_prefetch_hits", 20,
+                                          MYSQL_TYPE_LONGLONG),
+                          mem_root);
+    field_list->push_back(new (mem_root)
+                          Item_return_int(thd, "Slave_prefetch_misses", 20,
+                                          MYSQL_TYPE_LONGLONG),
+                          mem_root);
   }
   DBUG_VOID_RETURN;
 }
@@ -3269,6 +3285,12 @@ static bool send_show_master_info_data(THD *thd, Master_info *mi, bool full,
       protocol->store((uint32)    mi->received_heartbeats);
       protocol->store((double)    mi->heartbeat_period, 3, &tmp);
       protocol->store(gtid_pos->ptr(), gtid_pos->length(), &my_charset_bin);
+      protocol->store((ulonglong)
+                      my_atomic_load64_explicit(&mi->rli.parallel.prefetch.hits,
+                                                MY_MEMORY_ORDER_RELAXED));
+      protocol->store((ulonglong)
+                      my_atomic_load64_explicit(&mi->rli.parallel.prefetch.misses,
+                                                MY_MEMORY_ORDER_RELAXED));
     }
 
     mysql_mutex_unlock(&mi->rli.err_lock);
@@ -3822,6 +3844,13 @@ apply_event_and_update_pos_apply(Log_event* ev, THD* thd, rpl_group_info *rgi,
                             ev->get_type_str(), explain[reason]));
 #endif
 
+  /*
+    Replication threads never end a command. Make the status counted by
+    the event part of the global status before its position is updated.
+  */
+  if (thd->slave_thread)
+    thd->fold_status_to_global();
+
   DBUG_PRINT("info", ("apply_event error = %d", exec_res));
   if (exec_res == 0)
   {
@@ -4771,6 +4800,7 @@ Stopping slave I/O thread due to out-of-memory error from master");
                    "could not queue event from master");
         goto err;
       }
+      thd->fold_status_to_global();
 
       if (RUN_HOOK(binlog_relay_io, after_queue_event,
                    (thd, mi, event_buf, event_len, synced)))
@@ -5336,6 +5366,9 @@ pthread_handler_t handle_slave_sql(void *arg)
   }
   mysql_mutex_unlock(&rli->data_lock);
 
+  if (mi->using_parallel())
+    rli->parallel.prefetch.start_thread(rli);
+
   /* Read queries from the IO/THREAD until this thread is killed */
 
   thd->set_command(COM_SLAVE_SQL);
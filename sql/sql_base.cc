@@ -374,6 +374,7 @@ bool close_cached_tables(THD *thd, TABLE_LIST *tables,
     tc_purge(true);
     /* Free table shares which were not freed implicitly by loop above. */
     tdc_purge(true);
+    is_tables_cache_flush();
   }
   else
   {
@@ -2176,6 +2176,7 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
 
   thd->set_sent_row_count(thd->limit_found_rows = query->found_rows());
   thd->status_var.last_query_cost= 0.0;
+  thd->status_var.last_query_partial_plans= 0;
   thd->query_plan_flags= (thd->query_plan_flags & ~QPLAN_QC_NO) | QPLAN_QC;
   if (!thd->get_sent_row_count())
     status_var_increment(thd->status_var.empty_queries);
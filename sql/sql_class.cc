@@ -62,6 +62,7 @@
 #include "sql_select.h" /* declares create_tmp_table() */
 #include "debug_sync.h"
 #include "sql_parse.h"                          // is_update_query
+#include "sql_prepare.h"                        // parse_cache_free
 #include "sql_callback.h"
 #include "lock.h"
 #include "wsrep_mysqld.h"
@@ -791,6 +792,7 @@ THD::THD(my_thread_id id, bool is_wsrep_applier)
                  MYF(MY_THREAD_SPECIFIC));
 
   stmt_arena= this;
+  parse_cache= NULL;
   thread_stack= 0;
   scheduler= thread_scheduler;                 // Will be fixed later
   event_scheduler.data= 0;
@@ -1312,7 +1314,9 @@ void THD::init(void)
   reset_binlog_local_stmt_filter();
   set_status_var_init();
   bzero((char *) &org_status_var, sizeof(org_status_var));
+  bzero((char *) &status_var_folded, sizeof(status_var_folded));
   status_in_global= 0;
+  status_folded= 0;
   start_bytes_received= 0;
   last_commit_gtid.seq_no= 0;
   last_stmt= NULL;
@@ -1468,6 +1472,7 @@ void THD::change_user(void)
   thd_clear_errors(this);
   init();
   stmt_map.reset();
+  parse_cache_free(this);
   my_hash_init(&user_vars, system_charset_info, USER_VARS_HASH_SIZE, 0, 0,
                (my_hash_get_key) get_var_key,
                (my_hash_free_key) free_user_var, 0);
@@ -1572,6 +1577,7 @@ void THD::free_connection()
   main_security_ctx.destroy();
   /* close all prepared statements, to save memory */
   stmt_map.reset();
+  parse_cache_free(this);
   free_connection_done= 1;
 #if defined(ENABLED_PROFILING)
   profiling.restart();                          // Reset profiling
@@ -1795,6 +1801,50 @@ void add_diff_to_status(STATUS_VAR *to_var, STATUS_VAR *from_var,
   */
 }
 
+/*
+  Add what the thread has counted since the last call to its status shard
+
+  NOTES
+    Called at the end of every command, and by replication threads for
+    every event. Status counted until now is from then on part of SHOW
+    GLOBAL STATUS without calc_sum_of_all_status() having to add this
+    thread's status_var. Memory allocated for global use is added to
+    global_status_var right away.
+*/
+
+void THD::fold_status_to_global()
+{
+  struct status_shard *shard= &status_shards[thread_id % STATUS_SHARDS];
+
+  mysql_mutex_lock(&shard->lock);
+  add_diff_to_status(&shard->status, &status_var, &status_var_folded);
+  shard->status.local_memory_used+= (status_var.local_memory_used -
+                                     status_var_folded.local_memory_used);
+  mysql_mutex_unlock(&shard->lock);
+  memcpy(&status_var_folded, &status_var,
+         offsetof(STATUS_VAR, last_cleared_system_status_var));
+  status_var_folded.local_memory_used= status_var.local_memory_used;
+  update_global_memory_status(status_var.global_memory_used);
+  status_var.global_memory_used= 0;
+  status_folded= 1;
+}
+
+
+/*
+  Take the thread local memory of the thread out of its status shard,
+  when the thread no longer counts in the global status
+*/
+
+void THD::unfold_local_memory()
+{
+  struct status_shard *shard= &status_shards[thread_id % STATUS_SHARDS];
+
+  mysql_mutex_lock(&shard->lock);
+  shard->status.local_memory_used-= status_var_folded.local_memory_used;
+  mysql_mutex_unlock(&shard->lock);
+  status_var_folded.local_memory_used= 0;
+}
+
 #define SECONDS_TO_WAIT_FOR_KILL 2
 #if !defined(__WIN__) && defined(HAVE_SELECT)
 /* my_sleep() can wait for sub second times */
@@ -6657,6 +6707,7 @@ int THD::binlog_write_row(TABLE* table, bool is_trans,
   if (unlikely(ev == 0))
     return HA_ERR_OUT_OF_MEM;
 
+  binlog_add_row_to_writeset(table, is_trans, record, NULL);
   return ev->add_row_data(row_data, len);
 }
 
@@ -6712,6 +6763,8 @@ int THD::binlog_update_row(TABLE* table, bool is_trans,
   if (unlikely(ev == 0))
     return HA_ERR_OUT_OF_MEM;
 
+  binlog_add_row_to_writeset(table, is_trans, before_record, table->read_set);
+  binlog_add_row_to_writeset(table, is_trans, after_record, table->read_set);
   int error=  ev->add_row_data(before_row, before_size) ||
               ev->add_row_data(after_row, after_size);
 
@@ -6772,6 +6825,7 @@ int THD::binlog_delete_row(TABLE* table, bool is_trans,
   if (unlikely(ev == 0))
     return HA_ERR_OUT_OF_MEM;
 
+  binlog_add_row_to_writeset(table, is_trans, record, old_read_set);
 
   int error= ev->add_row_data(row_data, len);
 
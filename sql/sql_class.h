@@ -575,6 +575,7 @@ typedef struct system_variables
   ulong net_retry_count;
   ulong net_wait_timeout;
   ulong net_write_timeout;
+  ulong optimizer_prefix_memo_min_tables;
   ulong optimizer_prune_level;
   ulong optimizer_search_depth;
   ulong optimizer_selectivity_sampling_limit;
@@ -596,6 +597,7 @@ typedef struct system_variables
   ulong range_alloc_block_size;
   ulong query_alloc_block_size;
   ulong query_prealloc_size;
+  ulong parse_cache_size;
   ulong trans_alloc_block_size;
   ulong trans_prealloc_size;
   ulong log_warnings;
@@ -686,6 +688,7 @@ typedef struct system_variables
   ulong wsrep_retry_autocommit;
   ulong wsrep_OSU_method;
   double long_query_time_double, max_statement_time_double;
+  double sample_percentage;
 
   my_bool pseudo_slave_mode;
 
@@ -777,8 +780,18 @@ typedef struct system_status_var
   ulong select_range_count_;
   ulong select_range_check_count_;
   ulong select_scan_count_;
+  ulong range_estimate_cache_hits;
+  ulong range_estimate_cache_misses;
+  ulong parse_cache_hits;
+  ulong parse_cache_misses;
   ulong update_scan_count;
   ulong delete_scan_count;
+  /* How the slave located the rows of update and delete row events */
+  ulong slave_rows_lookup_position;
+  ulong slave_rows_lookup_index;
+  ulong slave_rows_lookup_index_scan;
+  ulong slave_rows_lookup_table_scan;
+  ulong slave_rows_lookup_hash_scan;
   ulong executed_triggers;
   ulong long_query_count;
   ulong filesort_merge_passes_;
@@ -826,6 +839,7 @@ typedef struct system_status_var
   ulonglong table_open_cache_hits;
   ulonglong table_open_cache_misses;
   ulonglong table_open_cache_overflows;
+  ulonglong last_query_partial_plans;
   double last_query_cost;
   double cpu_time, busy_time;
   /* Don't initialize */
@@ -856,6 +870,26 @@ void add_to_status(STATUS_VAR *to_var, STATUS_VAR *from_var);
 void add_diff_to_status(STATUS_VAR *to_var, STATUS_VAR *from_var,
                         STATUS_VAR *dec_var);
 
+/*
+  Status of commands that connection threads have finished executing, and
+  of events that replication threads have applied.
+  THD::fold_status_to_global() adds to the shard selected by the thread
+  id, so that threads ending commands don't contend on LOCK_status and
+  SHOW GLOBAL STATUS only has to sum STATUS_SHARDS arrays instead of the
+  status of every connection. status.local_memory_used of a shard is the
+  thread local memory its live threads had when they last folded.
+*/
+
+#define STATUS_SHARDS 64
+
+struct MY_ALIGNED(CPU_LEVEL1_DCACHE_LINESIZE) status_shard
+{
+  mysql_mutex_t lock;
+  STATUS_VAR status;
+};
+
+extern struct status_shard status_shards[STATUS_SHARDS];
+
 /*
   Update global_memory_used. We have to do this with atomic_add as the
   global value can change outside of LOCK_status.
@@ -2152,6 +2186,8 @@ class THD :public Statement,
   struct  system_variables variables;	// Changeable local variables
   struct  system_status_var status_var; // Per thread statistic vars
   struct  system_status_var org_status_var; // For user statistics
+  /* Part of status_var already added to status_shards */
+  struct  system_status_var status_var_folded;
   struct  system_status_var *initial_status_var; /* used by show status */
   THR_LOCK_INFO lock_info;              // Locking info of this thread
   /**
@@ -2168,6 +2204,8 @@ class THD :public Statement,
 
   /* all prepared statements and cursors of this connection */
   Statement_map stmt_map;
+  /* Parse trees of recently executed statements, see sql_prepare.cc */
+  struct Parse_cache *parse_cache;
 
   /* Last created prepared statement */
   Statement *last_stmt;
@@ -2333,6 +2371,9 @@ class THD :public Statement,
   /* Set to 1 if status of this THD is already in global status */
   bool status_in_global;
 
+  /* Set to 1 once the thread folds its own status into status_shards */
+  bool status_folded;
+
   /* 
     To signal that the tmp table to be created is created for materialized
     derived table or a view.
@@ -2360,6 +2401,8 @@ class THD :public Statement,
                         const uchar *buf);
   int binlog_update_row(TABLE* table, bool is_transactional,
                         const uchar *old_data, const uchar *new_data);
+  void binlog_add_row_to_writeset(TABLE *table, bool is_transactional,
+                                  const uchar *record, const MY_BITMAP *cols);
   static void binlog_prepare_row_images(TABLE* table);
 
   void set_server_id(uint32 sid) { variables.server_id = sid; }
@@ -4274,11 +4317,25 @@ class THD :public Statement,
   /* Wake this thread up from wait_for_wakeup_ready(). */
   void signal_wakeup_ready();
 
+  /*
+    Add the part of status_var that has not been folded into
+    status_shards to global_status_var. Caller must hold LOCK_status.
+  */
+  void add_unfolded_status_to_global()
+  {
+    add_diff_to_status(&global_status_var, &status_var, &status_var_folded);
+    update_global_memory_status(status_var.global_memory_used);
+  }
+
+  void fold_status_to_global();
+  void unfold_local_memory();
+
   void add_status_to_global()
   {
     DBUG_ASSERT(status_in_global == 0);
     mysql_mutex_lock(&LOCK_status);
-    add_to_status(&global_status_var, &status_var);
+    add_unfolded_status_to_global();
+    unfold_local_memory();
     /* Mark that this THD status has already been added in global status */
     status_var.global_memory_used= 0;
     status_in_global= 1;
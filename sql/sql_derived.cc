@@ -1020,6 +1020,99 @@ bool TABLE_LIST::fill_recursive(THD *thd)
 }
 
 
+/* Whether a condition was pushed into any select of the unit */
+
+static bool unit_has_pushed_cond(st_select_lex_unit *unit)
+{
+  for (st_select_lex *sl= unit->first_select(); sl; sl= sl->next_select())
+  {
+    if (sl->cond_pushed_into_where || sl->cond_pushed_into_having)
+      return true;
+  }
+  return false;
+}
+
+
+/* Whether rows read from one tmp table can be written into the other */
+
+static bool tmp_tables_have_same_rows(TABLE *a, TABLE *b)
+{
+  if (a->s->fields != b->s->fields || a->s->reclength != b->s->reclength)
+    return false;
+  for (uint i= 0; i < a->s->fields; i++)
+  {
+    Field *fa= a->field[i], *fb= b->field[i];
+    if (!fa->eq_def(fb) ||
+        fa->offset(a->record[0]) != fb->offset(b->record[0]) ||
+        fa->maybe_null() != fb->maybe_null() ||
+        (fa->maybe_null() &&
+         (fa->null_offset() != fb->null_offset() ||
+          fa->null_bit != fb->null_bit)))
+      return false;
+  }
+  return true;
+}
+
+
+/*
+  Fill the other references to a non-recursive CTE with the rows of
+  'derived', which has just been materialized.
+
+  @details
+  Every reference to a CTE has its own copy of the specification, which is
+  optimized and executed separately. Once one of them is materialized, the
+  other references in the same select get a copy of its rows instead, so
+  the specification is executed only once. The keys added to the tables of
+  the references for their join conditions may differ. A reference is
+  filled separately if a condition was pushed into its specification, or
+  into the one of 'derived', as then their rows differ.
+
+  @return FALSE  OK
+  @return TRUE   Error
+*/
+
+static bool share_materialized_cte(THD *thd, LEX *lex, TABLE_LIST *derived)
+{
+  With_element *with= derived->with;
+  TABLE *table= derived->table;
+  DBUG_ENTER("share_materialized_cte");
+
+  if (!with || with->is_recursive || !derived->select_lex ||
+      lex->describe || lex->analyze_stmt ||
+      derived->get_unit()->uncacheable ||
+      unit_has_pushed_cond(derived->get_unit()))
+    DBUG_RETURN(FALSE);
+
+  List_iterator_fast<TABLE_LIST> ti(derived->select_lex->leaf_tables);
+  TABLE_LIST *tl;
+  while ((tl= ti++))
+  {
+    st_select_lex_unit *unit= tl->get_unit();
+    if (tl == derived || tl->with != with ||
+        !tl->is_materialized_derived() || !tl->derived_result ||
+        !tl->table || unit->executed || unit->uncacheable ||
+        unit_has_pushed_cond(unit) ||
+        !tmp_tables_have_same_rows(table, tl->table))
+      continue;
+
+    if (mysql_derived_create(thd, lex, tl))
+      DBUG_RETURN(TRUE);
+
+    DBUG_PRINT("info", ("Copying rows of CTE '%s' into '%s'",
+                        derived->alias, tl->alias));
+    bool res= table->insert_all_rows_into_tmp_table(thd, tl->table,
+                                    &tl->derived_result->tmp_table_param,
+                                    false);
+    table->file->ha_index_or_rnd_end();
+    if (res)
+      DBUG_RETURN(TRUE);
+    unit->executed= TRUE;
+    unit->cleanup();
+  }
+  DBUG_RETURN(FALSE);
+}
+
+
 /*
   Execute subquery of a materialized derived table/view and fill the result
   table.
@@ -1121,6 +1214,8 @@ bool mysql_derived_fill(THD *thd, LEX *lex, TABLE_LIST *derived)
     if (derived_result->flush())
       res= TRUE;
     unit->executed= TRUE;
+    if (!res)
+      res= share_materialized_cte(thd, lex, derived);
   }
 err:
   if (res || (!lex->describe && !derived_is_recursive && !unit->uncacheable)) 
@@ -888,12 +888,20 @@ bool mysql_insert(THD *thd,TABLE_LIST *table_list,
       that reads from the table being inserted to.
       Engines can't handle a bulk insert in parallel with a read form the
       same table in the same connection.
+      For array binding of a command that iterates over the parameter
+      sets itself, the number of parameter sets is not known in advance,
+      so the engine is told that the number of rows is unknown. Other
+      commands (REPLACE) are executed once per parameter set, and a bulk
+      insert per row would only add overhead.
     */
+    bool bulk_array= thd->is_bulk_op() &&
+      (sql_command_flags[thd->lex->sql_command] & CF_SP_BULK_OPTIMIZED);
     if (thd->locked_tables_mode <= LTM_LOCK_TABLES &&
-       values_list.elements > 1)
+       (values_list.elements > 1 || bulk_array))
     {
       using_bulk_insert= 1;
-      table->file->ha_start_bulk_insert(values_list.elements);
+      table->file->ha_start_bulk_insert(bulk_array ?
+                                        0 : values_list.elements);
     }
   }
 
@@ -3034,6 +3042,7 @@ pthread_handler_t handle_delayed_insert(void *arg)
           /* Some fatal error */
           thd->set_killed(KILL_CONNECTION);
         }
+        thd->fold_status_to_global();
       }
       di->status=0;
       if (!di->stacked_inserts && !di->tables_in_use && thd->lock)
@@ -32,6 +32,7 @@
 #include "sql_base.h"
 #include "sql_select.h"
 #include "opt_subselect.h"
+#include <my_bit.h>
 
 #define NO_MORE_RECORDS_IN_BUFFER  (uint)(-1)
 
@@ -2669,6 +2670,7 @@ int JOIN_CACHE_HASHED::init(bool for_explain)
   DBUG_ENTER("JOIN_CACHE_HASHED::init");
 
   hash_table= 0;
+  key_filter= 0;
   key_entries= 0;
 
   key_length= ref->key_length;
@@ -2686,7 +2688,7 @@ int JOIN_CACHE_HASHED::init(bool for_explain)
   ref_key_info= join_tab->get_keyinfo_by_key_no(join_tab->ref.key);
   ref_used_key_parts= join_tab->ref.key_parts;
 
-  hash_func= &JOIN_CACHE_HASHED::get_hash_idx_simple;
+  hash_func= &JOIN_CACHE_HASHED::get_hash_simple;
   hash_cmp_func= &JOIN_CACHE_HASHED::equal_keys_simple;
 
   KEY_PART_INFO *key_part= ref_key_info->key_part;
@@ -2695,7 +2697,7 @@ int JOIN_CACHE_HASHED::init(bool for_explain)
   {
     if (!key_part->field->eq_cmp_as_binary())
     {
-      hash_func= &JOIN_CACHE_HASHED::get_hash_idx_complex;
+      hash_func= &JOIN_CACHE_HASHED::get_hash_complex;
       hash_cmp_func= &JOIN_CACHE_HASHED::equal_keys_complex;
       break;
     }
@@ -2769,8 +2771,28 @@ int JOIN_CACHE_HASHED::init_hash_table()
       break;
   }
    
+  /*
+    Reserve the very end of the buffer for a Bloom filter over the keys
+    with 8 bits per hash entry, unless it would take too much of it.
+  */
+  size_t key_filter_size= 0;
+  key_filter= 0;
+  key_filter_shift= 0;
+  if (use_key_filter())
+  {
+    key_filter_size= my_round_up_to_next_power(hash_entries);
+    if (key_filter_size <= buff_size/16 && key_filter_size <= (1U << 28))
+    {
+      key_filter= buff + buff_size - key_filter_size;
+      key_filter_bits= (uint) key_filter_size * 8;
+      key_filter_shift= 32 - my_bit_log2(key_filter_bits);
+    }
+    else
+      key_filter_size= 0;
+  }
+
   /* Initialize the hash table */ 
-  hash_table= buff + (buff_size-hash_entries*size_of_key_ofs);
+  hash_table= buff + (buff_size-hash_entries*size_of_key_ofs-key_filter_size);
   cleanup_hash_table();
   curr_key_entry= hash_table;
 
@@ -2968,6 +2990,8 @@ bool JOIN_CACHE_HASHED::put_record()
     }
     last_key_entry= cp;
     DBUG_ASSERT(last_key_entry >= end_pos);
+    if (key_filter)
+      add_key_to_filter(key);
     /* Increment the counter of key_entries in the hash table */ 
     key_entries++;
   }  
@@ -3085,7 +3109,7 @@ bool JOIN_CACHE_HASHED::key_search(uchar *key, uint key_len,
                                    uchar **key_ref_ptr) 
 {
   bool is_found= FALSE;
-  uint idx= (this->*hash_func)(key, key_length);
+  uint idx= (uint) ((this->*hash_func)(key, key_length) % hash_entries);
   uchar *ref_ptr= hash_table+size_of_key_ofs*idx;
   while (!is_null_key_ref(ref_ptr))
   {
@@ -3109,21 +3133,22 @@ bool JOIN_CACHE_HASHED::key_search(uchar *key, uint key_len,
   Hash function that considers a key in the hash table as byte array
 
   SYNOPSIS
-    get_hash_idx_simple()
+    get_hash_simple()
       key             pointer to the key value
       key_len         key value length
       
   DESCRIPTION
-    The function calculates an index of the hash entry in the hash table
-    of the join buffer for the given key. It considers the key just as
-    a sequence of bytes of the length key_len.
+    The function calculates the hash value for the given key. It considers
+    the key just as a sequence of bytes of the length key_len.
+    The index of the hash entry in the hash table of the join buffer is
+    the hash value modulo the number of hash entries.
 
   RETURN VALUE
-    the calculated index of the hash entry for the given key  
+    the calculated hash value for the given key  
 */
 
 inline
-uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
+ulong JOIN_CACHE_HASHED::get_hash_simple(uchar* key, uint key_len)
 {
   ulong nr= 1;
   ulong nr2= 4;
@@ -3134,7 +3159,7 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
     nr^= (ulong) ((((uint) nr & 63)+nr2)*((uint) *pos))+ (nr << 8);
     nr2+= 3;
   }
-  return nr % hash_entries;
+  return nr;
 }
 
 
@@ -3142,13 +3167,13 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
   Hash function that takes into account collations of the components of the key  
 
   SYNOPSIS
-    get_hash_idx_complex()
+    get_hash_complex()
       key             pointer to the key value
       key_len         key value length
       
   DESCRIPTION
-    The function calculates an index of the hash entry in the hash table
-    of the join buffer for the given key. It takes into account that the
+    The function calculates the hash value for the given key in the hash
+    table of the join buffer. It takes into account that the
     components of the key may be of a varchar type with different collations.
     The function guarantees that the same hash value for any two equal
     keys that may differ as byte sequences.
@@ -3158,14 +3183,70 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
     operation.
 
   RETURN VALUE
-    the calculated index of the hash entry for the given key  
+    the calculated hash value for the given key  
 */
 
 inline
-uint JOIN_CACHE_HASHED::get_hash_idx_complex(uchar *key, uint key_len)
+ulong JOIN_CACHE_HASHED::get_hash_complex(uchar *key, uint key_len)
+{
+  return key_hashnr(ref_key_info, ref_used_key_parts, key);
+}
+
+
+/*
+  Add a key to the Bloom filter over the keys of the hash table
+
+  SYNOPSIS
+    add_key_to_filter()
+      key             pointer to the key value
+
+  DESCRIPTION
+    The function sets the two bits of the key filter that correspond to
+    the hash value of the given key. The first bit is taken from the low
+    bits of the hash value, the second one from the high bits of its
+    Fibonacci hash.
+
+  RETURN VALUE
+    none
+*/
+
+void JOIN_CACHE_HASHED::add_key_to_filter(uchar *key)
+{
+  uint32 nr= (uint32) (this->*hash_func)(key, key_length);
+  uint bit1= nr & (key_filter_bits-1);
+  uint bit2= (uint32) (nr * 2654435769U) >> key_filter_shift;
+  key_filter[bit1 >> 3]|= (uchar) (1 << (bit1 & 7));
+  key_filter[bit2 >> 3]|= (uchar) (1 << (bit2 & 7));
+}
+
+
+/*
+  Check whether a key may be found in the hash table of the join buffer
+
+  SYNOPSIS
+    key_filter_contains()
+      key             pointer to the key value
+
+  DESCRIPTION
+    The function checks the bits of the Bloom filter that would have been
+    set by add_key_to_filter() for the given key. If any of them is not
+    set the key is certainly not in the hash table. Otherwise it may be
+    there. If there is no key filter the function always returns TRUE.
+
+  RETURN VALUE
+    FALSE   the key is not in the hash table
+    TRUE    otherwise
+*/
+
+bool JOIN_CACHE_HASHED::key_filter_contains(uchar *key)
 {
-  return 
-    (uint) (key_hashnr(ref_key_info, ref_used_key_parts, key) % hash_entries);
+  if (!key_filter)
+    return TRUE;
+  uint32 nr= (uint32) (this->*hash_func)(key, key_length);
+  uint bit1= nr & (key_filter_bits-1);
+  uint bit2= (uint32) (nr * 2654435769U) >> key_filter_shift;
+  return (key_filter[bit1 >> 3] & (1 << (bit1 & 7))) &&
+         (key_filter[bit2 >> 3] & (1 << (bit2 & 7)));
 }
 
 
@@ -3380,14 +3461,19 @@ int JOIN_TAB_SCAN::next()
     join_tab->tracker->r_rows++;
   }
 
-  while (!err && select && (skip_rc= select->skip_record(thd)) <= 0)
+  while (!err)
   {
+    /*
+      Move to the next record if the last retrieved record cannot match
+      any record from the join buffer or does not meet the condition pushed
+      to the table join_tab.
+    */
+    if (cache->skip_candidate_by_join_key())
+      skip_rc= 0;
+    else if (!select || (skip_rc= select->skip_record(thd)) > 0)
+      break;
     if (thd->check_killed() || skip_rc < 0) 
       return 1;
-    /* 
-      Move to the next record if the last retrieved record does not
-      meet the condition pushed to the table join_tab.
-    */
     err= info->read_record();
     if (!err)
     {
@@ -3651,6 +3737,36 @@ uchar *JOIN_CACHE_BNLH::get_matching_chain_by_join_key()
 }
 
 
+/*
+  Check whether the current record of the joined table can match nothing
+
+  SYNOPSIS
+    skip_candidate_by_join_key()
+
+  DESCRIPTION
+    This implementation of the virtual method builds the join key out of
+    the record in the record buffer of join_tab and checks it against the
+    Bloom filter over the keys of the join buffer. This allows the scan
+    of join_tab to reject most records without any matches before the
+    condition pushed to join_tab is evaluated for them and before the
+    hash table of the join buffer is looked through.
+
+  RETURN VALUE
+    TRUE    no record in the join buffer can match the current record
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::skip_candidate_by_join_key()
+{
+  if (!has_key_filter())
+    return FALSE;
+  TABLE *table= join_tab->table;
+  KEY *keyinfo= join_tab->get_keyinfo_by_key_no(join_tab->ref.key);
+  key_copy(key_buff, table->record[0], keyinfo, key_length, TRUE);
+  return !key_filter_contains(key_buff);
+}
+
+
 /*
   Prepare to iterate over the BNLH join cache buffer to look for matches 
 
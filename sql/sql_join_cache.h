@@ -483,6 +483,12 @@ class JOIN_CACHE :public Sql_alloc
   */  
   virtual uint get_number_of_ranges_for_mrr() { return 0; };
 
+  /* 
+    Check whether the record of the joined table read into the record buffer
+    can be skipped as it cannot match any record from the join cache buffer
+  */ 
+  virtual bool skip_candidate_by_join_key() { return FALSE; }
+
   /* 
     Shall prepare to look for records from the join cache buffer that would
     match the record of the joined table read into the record buffer
@@ -763,7 +769,7 @@ class JOIN_CACHE :public Sql_alloc
 class JOIN_CACHE_HASHED: public JOIN_CACHE
 {
 
-  typedef uint (JOIN_CACHE_HASHED::*Hash_func) (uchar *key, uint key_len);
+  typedef ulong (JOIN_CACHE_HASHED::*Hash_func) (uchar *key, uint key_len);
   typedef bool (JOIN_CACHE_HASHED::*Hash_cmp_func) (uchar *key1, uchar *key2,
                                                     uint key_len);
   
@@ -784,6 +790,16 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   /* Number of hash entries in the hash table */
   uint hash_entries;
 
+  /* 
+    The Bloom filter over the keys in the hash table placed after it at
+    the very end of the join buffer, or 0 if it is not used
+  */
+  uchar *key_filter;
+  /* Number of bits in the key filter, always a power of 2 */
+  uint key_filter_bits;
+  /* 32 minus the binary logarithm of key_filter_bits */
+  uint key_filter_shift;
+
 
   /* The position of the currently retrieved key entry in the hash table */
   uchar *curr_key_entry;
@@ -791,14 +807,16 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   /* The offset of the data fields from the beginning of the record fields */
   uint data_fields_offset;
 
-  inline uint get_hash_idx_simple(uchar *key, uint key_len);
-  inline uint get_hash_idx_complex(uchar *key, uint key_len);
+  inline ulong get_hash_simple(uchar *key, uint key_len);
+  inline ulong get_hash_complex(uchar *key, uint key_len);
 
   inline bool equal_keys_simple(uchar *key1, uchar *key2, uint key_len);
   inline bool equal_keys_complex(uchar *key1, uchar *key2, uint key_len);
 
   int init_hash_table();
   void cleanup_hash_table();
+
+  void add_key_to_filter(uchar *key);
   
 protected:
 
@@ -972,6 +990,14 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   /* Search for a key in the hash table of the join buffer */
   bool key_search(uchar *key, uint key_len, uchar **key_ref_ptr);
 
+  /* Shall return TRUE if a Bloom filter over the keys is to be built */
+  virtual bool use_key_filter() { return FALSE; }
+
+  bool has_key_filter() { return key_filter != 0; }
+
+  /* Check whether a key may be found in the hash table of the join buffer */
+  bool key_filter_contains(uchar *key);
+
   /* Reallocate the join buffer of a hashed join cache */
   int realloc_buffer();
 
@@ -1170,6 +1196,10 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
   */
   uchar *get_matching_chain_by_join_key();
 
+  bool use_key_filter() { return TRUE; }
+
+  bool skip_candidate_by_join_key();
+
   bool prepare_look_for_matches(bool skip_last);
 
   uchar *get_next_candidate_for_match();
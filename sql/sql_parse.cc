@@ -2417,6 +2417,10 @@ bool dispatch_command(enum enum_server_command command, THD *thd,
   thd->reset_kill_query();  /* Ensure that killed_errmsg is released */
   free_root(thd->mem_root,MYF(MY_KEEP_PREALLOC));
 
+  /* After log_slow_statement(), so that Slow_queries counts this command */
+  if (!is_com_multi)
+    thd->fold_status_to_global();
+
 #if defined(ENABLED_PROFILING)
   thd->profiling.finish_current_query();
 #endif
@@ -3721,6 +3725,7 @@ mysql_execute_command(THD *thd)
 #endif /* WITH_WSREP */
 
     thd->status_var.last_query_cost= 0.0;
+    thd->status_var.last_query_partial_plans= 0;
 
     /*
       lex->exchange != NULL implies SELECT .. INTO OUTFILE and this
@@ -7883,9 +7888,15 @@ void mysql_parse(THD *thd, char *rawbuf, uint length,
   {
     LEX *lex= thd->lex;
 
-    bool err= parse_sql(thd, parser_state, NULL, true);
+    bool cached= thd->parse_cache &&
+                 parse_cache_execute(thd, rawbuf, length);
+    bool err= !cached && parse_sql(thd, parser_state, NULL, true);
 
-    if (!err)
+    if (cached)
+    {
+      /* Executed with the parse tree of an earlier execution */
+    }
+    else if (!err)
     {
       thd->m_statement_psi=
         MYSQL_REFINE_STATEMENT(thd->m_statement_psi,
@@ -7922,6 +7933,9 @@ void mysql_parse(THD *thd, char *rawbuf, uint length,
             lex->safe_to_cache_query= 0;
             thd->server_status|= SERVER_MORE_RESULTS_EXISTS;
           }
+          bool add_to_parse_cache= thd->variables.parse_cache_size &&
+                                   !found_semicolon &&
+                                   parse_cache_can_add(thd);
           lex->set_trg_event_type_for_tables();
           MYSQL_QUERY_EXEC_START(thd->query(),
                                  thd->thread_id,
@@ -7932,6 +7946,9 @@ void mysql_parse(THD *thd, char *rawbuf, uint length,
 
           error= mysql_execute_command(thd);
           MYSQL_QUERY_EXEC_DONE(error);
+          if (add_to_parse_cache && !error && !thd->is_error() &&
+              !thd->get_stmt_da()->statement_warn_count())
+            parse_cache_add(thd, rawbuf, length);
 	}
       }
     }
@@ -121,6 +121,7 @@ When one supplies long data for a placeholder:
 #include "lock.h"                               // MYSQL_OPEN_FORCE_SHARED_MDL
 #include "sql_handler.h"
 #include "transaction.h"                        // trans_rollback_implicit
+#include "sql_connect.h"                        // check_mqh
 #include "wsrep_mysqld.h"
 
 /**
@@ -155,7 +156,13 @@ class Prepared_statement: public Statement
   enum flag_values
   {
     IS_IN_USE= 1,
-    IS_SQL_PREPARE= 2
+    IS_SQL_PREPARE= 2,
+    /*
+      The statement is in the parse cache of the connection. The client
+      sent it as a plain query, so it is not counted or logged as prepared
+      or executed.
+    */
+    IS_PARSE_CACHED= 4
   };
 
   THD *thd;
@@ -208,6 +215,9 @@ class Prepared_statement: public Statement
   inline bool is_in_use() { return flags & (uint) IS_IN_USE; }
   inline bool is_sql_prepare() const { return flags & (uint) IS_SQL_PREPARE; }
   void set_sql_prepare() { flags|= (uint) IS_SQL_PREPARE; }
+  inline bool is_parse_cached() const
+  { return flags & (uint) IS_PARSE_CACHED; }
+  void set_parse_cached() { flags|= (uint) IS_PARSE_CACHED; }
   bool prepare(const char *packet, uint packet_length);
   bool execute_loop(String *expanded_query,
                     bool open_cursor,
@@ -3477,6 +3487,270 @@ void mysql_sql_stmt_close(THD *thd)
 }
 
 
+/***************************************************************************
+ Parse cache
+****************************************************************************/
+
+/*
+  The parse cache keeps the parse trees of the last parse_cache_size
+  statements that a connection sent as plain queries, so that a statement
+  sent again with exactly the same text is not parsed again.
+
+  The text of a statement that parse_cache_can_add() accepts is remembered
+  after it was executed without errors and warnings. When the same text is
+  sent again, it is prepared as an SQL prepared statement and executed, and
+  from then on it is only executed. Prepared statements already do what is
+  needed to reuse a parse tree: the tree is restored after each execution,
+  and prepared again when a table it uses has changed.
+
+  The same text is parsed differently with another current database,
+  sql_mode or character set, so an entry is only used while they are the
+  same as when it was added.
+*/
+
+struct Parse_cache_entry
+{
+  Parse_cache_entry *next, **prev;      /* Eviction order, oldest first */
+  char *query;
+  uint length;
+  char *db;
+  sql_mode_t sql_mode;
+  CHARSET_INFO *character_set_client;
+  CHARSET_INFO *collation_connection;
+  /* NULL until the statement is sent the second time */
+  Prepared_statement *stmt;
+};
+
+static uchar *
+parse_cache_get_key(const uchar *data, size_t *len_ret,
+                    my_bool __attribute__((unused)))
+{
+  Parse_cache_entry *entry= (Parse_cache_entry *) data;
+  *len_ret= entry->length;
+  return (uchar *) entry->query;
+}
+
+
+static void parse_cache_free_entry(void *data)
+{
+  Parse_cache_entry *entry= (Parse_cache_entry *) data;
+  delete entry->stmt;
+  my_free(entry);
+}
+
+
+struct Parse_cache
+{
+  HASH hash;
+  I_P_List <Parse_cache_entry,
+            I_P_List_adapter<Parse_cache_entry,
+                             &Parse_cache_entry::next,
+                             &Parse_cache_entry::prev>,
+            I_P_List_null_counter,
+            I_P_List_fast_push_back<Parse_cache_entry> > list;
+
+  Parse_cache()
+  {
+    my_hash_init(&hash, &my_charset_bin, 16, 0, 0, parse_cache_get_key,
+                 parse_cache_free_entry, HASH_THREAD_SPECIFIC);
+  }
+  ~Parse_cache()
+  {
+    list.empty();
+    my_hash_free(&hash);
+  }
+};
+
+
+static void parse_cache_remove(Parse_cache *cache, Parse_cache_entry *entry)
+{
+  cache->list.remove(entry);
+  my_hash_delete(&cache->hash, (uchar *) entry);
+}
+
+
+static void parse_cache_evict(Parse_cache *cache, ulong size)
+{
+  while (cache->hash.records > size)
+    parse_cache_remove(cache, cache->list.front());
+}
+
+
+static bool parse_cache_entry_matches(THD *thd, Parse_cache_entry *entry)
+{
+  if (entry->sql_mode != thd->variables.sql_mode ||
+      entry->character_set_client != thd->variables.character_set_client ||
+      entry->collation_connection != thd->variables.collation_connection)
+    return false;
+  if (!entry->db || !thd->db)
+    return entry->db == thd->db;
+  return !strcmp(entry->db, thd->db);
+}
+
+
+/**
+  Whether the statement that was just parsed into thd->lex can be added to
+  the parse cache after it is executed.
+
+  Only single table and join SELECT, INSERT, REPLACE, UPDATE and DELETE
+  statements are cached, without EXPLAIN, SELECT ... INTO, PROCEDURE or
+  SET STATEMENT.
+*/
+
+bool parse_cache_can_add(THD *thd)
+{
+  LEX *lex= thd->lex;
+
+  switch (lex->sql_command) {
+  case SQLCOM_SELECT:
+  case SQLCOM_INSERT:
+  case SQLCOM_REPLACE:
+  case SQLCOM_UPDATE:
+  case SQLCOM_DELETE:
+    break;
+  default:
+    return false;
+  }
+  return !lex->describe && !lex->analyze_stmt && !lex->result &&
+         !lex->proc_list.elements && !lex->stmt_var_list.elements;
+}
+
+
+/**
+  Remember the text of a statement that was executed without errors and
+  warnings, so that its parse tree is kept if it is sent again.
+*/
+
+void parse_cache_add(THD *thd, const char *query, uint length)
+{
+  Parse_cache *cache= thd->parse_cache;
+  Parse_cache_entry *entry;
+  size_t db_length= thd->db ? thd->db_length + 1 : 0;
+  DBUG_ENTER("parse_cache_add");
+
+  DBUG_ASSERT(thd->variables.parse_cache_size);
+  if (!cache)
+  {
+    if (!(cache= new Parse_cache))
+      DBUG_VOID_RETURN;
+    thd->parse_cache= cache;
+  }
+  else if (my_hash_search(&cache->hash, (uchar *) query, length))
+    DBUG_VOID_RETURN;
+
+  parse_cache_evict(cache, thd->variables.parse_cache_size - 1);
+  if (!(entry= (Parse_cache_entry *) my_malloc(sizeof(*entry) + length +
+                                               db_length,
+                                               MYF(MY_THREAD_SPECIFIC |
+                                                   MY_WME))))
+    DBUG_VOID_RETURN;
+  entry->query= (char *) (entry + 1);
+  memcpy(entry->query, query, length);
+  entry->length= length;
+  entry->db= NULL;
+  if (thd->db)
+    entry->db= (char *) memcpy(entry->query + length, thd->db, db_length);
+  entry->sql_mode= thd->variables.sql_mode;
+  entry->character_set_client= thd->variables.character_set_client;
+  entry->collation_connection= thd->variables.collation_connection;
+  entry->stmt= NULL;
+  if (my_hash_insert(&cache->hash, (uchar *) entry))
+  {
+    my_free(entry);
+    DBUG_VOID_RETURN;
+  }
+  cache->list.push_back(entry);
+  status_var_increment(thd->status_var.parse_cache_misses);
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Execute a statement sent as a plain query with the parse tree of an
+  earlier execution of the same text, if there is one.
+
+  Called from mysql_parse() after the query cache was checked.
+
+  @retval TRUE   the statement was executed (or failed with an error)
+  @retval FALSE  the statement is not in the parse cache, it must be parsed
+*/
+
+bool parse_cache_execute(THD *thd, const char *query, uint length)
+{
+  Parse_cache *cache= thd->parse_cache;
+  Parse_cache_entry *entry;
+  Prepared_statement *stmt;
+  String expanded_query;
+  DBUG_ENTER("parse_cache_execute");
+
+  /* parse_cache_size may have been decreased since the last statement */
+  if (!thd->variables.parse_cache_size)
+  {
+    parse_cache_free(thd);
+    DBUG_RETURN(FALSE);
+  }
+  parse_cache_evict(cache, thd->variables.parse_cache_size);
+
+  if (!(entry= (Parse_cache_entry *) my_hash_search(&cache->hash,
+                                                    (uchar *) query, length)))
+    DBUG_RETURN(FALSE);
+  if (!parse_cache_entry_matches(thd, entry))
+  {
+    parse_cache_remove(cache, entry);
+    DBUG_RETURN(FALSE);
+  }
+  cache->list.remove(entry);
+  cache->list.push_back(entry);
+  /*
+    The miss was counted when the statement was added. The second time it
+    is sent, it is a hit even though it is parsed to be prepared.
+  */
+  status_var_increment(thd->status_var.parse_cache_hits);
+
+  if (!(stmt= entry->stmt))
+  {
+    if (!(stmt= new Prepared_statement(thd)))
+      DBUG_RETURN(FALSE);
+    stmt->set_sql_prepare();
+    stmt->set_parse_cached();
+    if (stmt->prepare(query, length))
+    {
+      /* The statement fails as it would without the cache */
+      delete stmt;
+      parse_cache_remove(cache, entry);
+      DBUG_RETURN(TRUE);
+    }
+    entry->stmt= stmt;
+  }
+
+  thd->lex->sql_command= stmt->lex->sql_command;
+  thd->m_statement_psi=
+    MYSQL_REFINE_STATEMENT(thd->m_statement_psi,
+                           sql_statement_info[thd->lex->sql_command].m_key);
+#ifndef NO_EMBEDDED_ACCESS_CHECKS
+  if (mqh_used && thd->user_connect &&
+      check_mqh(thd, thd->lex->sql_command))
+  {
+    thd->net.error= 0;
+    DBUG_RETURN(TRUE);
+  }
+#endif
+
+  (void) stmt->execute_loop(&expanded_query, FALSE, NULL, NULL);
+  thd->free_items();    // Free items created by execute_loop()
+  DBUG_RETURN(TRUE);
+}
+
+
+/* Free the parse cache of a connection */
+
+void parse_cache_free(THD *thd)
+{
+  delete thd->parse_cache;
+  thd->parse_cache= NULL;
+}
+
+
 /**
   Handle long data in pieces from client.
 
@@ -3897,7 +4171,8 @@ bool Prepared_statement::prepare(const char *packet, uint packet_len)
     However, it seems handy if com_stmt_prepare is increased always,
     no matter what kind of prepare is processed.
   */
-  status_var_increment(thd->status_var.com_stmt_prepare);
+  if (!is_parse_cached())
+    status_var_increment(thd->status_var.com_stmt_prepare);
 
   if (! (lex= new (mem_root) st_lex_local))
     DBUG_RETURN(TRUE);
@@ -4037,7 +4312,7 @@ bool Prepared_statement::prepare(const char *packet, uint packet_len)
       sub-statements inside stored procedures are not logged into
       the general log.
     */
-    if (thd->spcont == NULL)
+    if (thd->spcont == NULL && !is_parse_cached())
       general_log_write(thd, COM_STMT_PREPARE, query(), query_length());
   }
   DBUG_RETURN(error);
@@ -4280,6 +4555,7 @@ Prepared_statement::execute_bulk_loop(String *expanded_query,
 {
   Reprepare_observer reprepare_observer;
   bool error= 0;
+  bool array_trx= FALSE;
   packet= packet_arg;
   packet_end= packet_end_arg;
   iterations= TRUE;
@@ -4328,6 +4604,25 @@ Prepared_statement::execute_bulk_loop(String *expanded_query,
   }
   read_types= FALSE;
 
+  /*
+    Commands that are not optimized for bulk execution run once per
+    parameter set. In autocommit mode, run them all in one transaction,
+    so that the array is committed, binary logged as one event group and
+    synced once instead of once per parameter set.
+  */
+  if (!(sql_command_flags[lex->sql_command] & CF_SP_BULK_OPTIMIZED) &&
+      !thd->in_multi_stmt_transaction_mode() &&
+      !thd->locked_tables_mode && !thd->in_sub_stmt)
+  {
+    if (trans_begin(thd))
+    {
+      reset_stmt_params(this);
+      thd->set_bulk_execution(0);
+      return true;
+    }
+    array_trx= TRUE;
+  }
+
 #ifdef NOT_YET_FROM_MYSQL_5_6
   if (unlikely(thd->security_ctx->password_expired &&
                !lex->is_change_password))
@@ -4351,8 +4646,8 @@ Prepared_statement::execute_bulk_loop(String *expanded_query,
     {
       if (set_bulk_parameters(TRUE))
       {
-        thd->set_bulk_execution(0);
-        return true;
+        error= true;
+        break;
       }
     }
 
@@ -4420,6 +4715,21 @@ Prepared_statement::execute_bulk_loop(String *expanded_query,
         goto reexecute;
     }
   }
+
+  if (array_trx)
+  {
+    /*
+      The array is executed as a whole: if one of the parameter sets
+      failed, the changes done by the previous ones are rolled back too.
+    */
+    thd->get_stmt_da()->set_overwrite_status(true);
+    if (error || thd->is_error())
+      trans_rollback(thd);
+    else
+      error= trans_commit(thd);
+    thd->get_stmt_da()->set_overwrite_status(false);
+    thd->mdl_context.release_transactional_locks();
+  }
   reset_stmt_params(this);
   thd->set_bulk_execution(0);
 
@@ -4488,8 +4798,10 @@ Prepared_statement::reprepare()
   copy.m_sql_mode= m_sql_mode;
 
   copy.set_sql_prepare(); /* To suppress sending metadata to the client. */
-
-  status_var_increment(thd->status_var.com_stmt_reprepare);
+  if (is_parse_cached())
+    copy.set_parse_cached();
+  else
+    status_var_increment(thd->status_var.com_stmt_reprepare);
 
   if (mysql_opt_change_db(thd, &stmt_db_name, &saved_cur_db_name, TRUE,
                           &cur_db_changed))
@@ -4648,7 +4960,8 @@ bool Prepared_statement::execute(String *expanded_query, bool open_cursor)
 
   LEX_CSTRING stmt_db_name= { db, db_length };
 
-  status_var_increment(thd->status_var.com_stmt_execute);
+  if (!is_parse_cached())
+    status_var_increment(thd->status_var.com_stmt_execute);
 
   if (flags & (uint) IS_IN_USE)
   {
@@ -4826,7 +5139,7 @@ bool Prepared_statement::execute(String *expanded_query, bool open_cursor)
     sub-statements inside stored procedures are not logged into
     the general log.
   */
-  if (error == 0 && thd->spcont == NULL)
+  if (error == 0 && thd->spcont == NULL && !is_parse_cached())
     general_log_write(thd, COM_STMT_EXECUTE, thd->query(), thd->query_length());
 
 error:
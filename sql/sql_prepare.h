@@ -83,6 +83,10 @@ void mysqld_stmt_fetch(THD *thd, char *packet, uint packet_length);
 void mysqld_stmt_reset(THD *thd, char *packet);
 void mysql_stmt_get_longdata(THD *thd, char *pos, ulong packet_length);
 void reinit_stmt_before_use(THD *thd, LEX *lex);
+bool parse_cache_execute(THD *thd, const char *query, uint length);
+bool parse_cache_can_add(THD *thd);
+void parse_cache_add(THD *thd, const char *query, uint length);
+void parse_cache_free(THD *thd);
 
 my_bool bulk_parameters_iterations(THD *thd);
 my_bool bulk_parameters_set(THD *thd);
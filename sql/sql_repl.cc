@@ -1384,6 +1384,82 @@ gtid_find_binlog_file(slave_connection_state *state, char *out_name,
 }
 
 
+/*
+  Return how far the binlog file can be read: the end position published to
+  dump threads for the active binlog file, and no limit for older files.
+*/
+static my_off_t
+binlog_readable_end(const char *log_name)
+{
+  char end_file[FN_REFLEN];
+  my_off_t end;
+
+  mysql_bin_log.lock_binlog_end_pos();
+  end= mysql_bin_log.get_binlog_end_pos(end_file);
+  mysql_bin_log.unlock_binlog_end_pos();
+  return strcmp(end_file, log_name) ? MY_FILEPOS_ERROR : end;
+}
+
+
+/*
+  Check that every event group before a GTID index entry would be skipped
+  when sending the binlog to a slave starting at the GTID position in
+  state (see send_event_to_slave()).
+
+  This is the case if every GTID in the binlog state at the entry is in a
+  domain of the slave position, and is either from another server_id or
+  before the slave position.
+*/
+static bool
+gtid_index_entry_before_pos(Binlog_gtid_index::entry *entry,
+                            slave_connection_state *state)
+{
+  for (uint32 i= 0; i < entry->count; i++)
+  {
+    const rpl_gtid *gtid= &entry->list[i];
+    slave_connection_state::entry *pos= state->find_entry(gtid->domain_id);
+    if (!pos ||
+        (pos->flags & slave_connection_state::START_ON_EMPTY_DOMAIN) ||
+        (gtid->server_id == pos->gtid.server_id &&
+         gtid->seq_no >= pos->gtid.seq_no))
+      return false;
+  }
+  return true;
+}
+
+
+/*
+  Find where to start sending a binlog file to a slave that connects with
+  GTID, using the GTID index of the file.
+
+  The binlog state only grows through the file, so the entries that pass
+  gtid_index_entry_before_pos() are a prefix of the index; we binary search
+  for the last one.
+
+  Returns the offset of that entry, or BIN_LOG_HEADER_SIZE to send the whole
+  file.
+*/
+static my_off_t
+gtid_index_start_pos(const char *log_name, slave_connection_state *state)
+{
+  Binlog_gtid_index index;
+  uint lo= 0, hi;
+
+  if (index.read(log_name, binlog_readable_end(log_name)))
+    return BIN_LOG_HEADER_SIZE;
+  hi= index.count;
+  while (lo < hi)
+  {
+    uint mid= (lo + hi) / 2;
+    if (gtid_index_entry_before_pos(&index.entries[mid], state))
+      lo= mid + 1;
+    else
+      hi= mid;
+  }
+  return lo ? index.entries[lo - 1].offset : BIN_LOG_HEADER_SIZE;
+}
+
+
 /*
   Given an old-style binlog position with file name and file offset, find the
   corresponding gtid position. If the offset is not at an event boundary, give
@@ -1407,6 +1483,8 @@ gtid_state_from_pos(const char *name, uint32 offset,
   int err;
   String packet;
   Format_description_log_event *fdev= NULL;
+  Binlog_gtid_index index;
+  Binlog_gtid_index::entry *index_entry= NULL;
 
   if (gtid_state->load((const rpl_gtid *)NULL, 0))
   {
@@ -1425,6 +1503,9 @@ gtid_state_from_pos(const char *name, uint32 offset,
     goto end;
   }
 
+  if (!index.read(name, binlog_readable_end(name)))
+    index_entry= index.find(offset);
+
   /*
     First we need to find the initial GTID_LIST_EVENT. We need this even
     if the offset is at the very start of the binlog file.
@@ -1535,6 +1616,21 @@ gtid_state_from_pos(const char *name, uint32 offset,
         goto end;
       }
       found_gtid_list_event= true;
+
+      /*
+        Continue from the last entry of the GTID index before offset, with
+        the binlog state recorded there.
+      */
+      if (index_entry && index_entry->offset > my_b_tell(&cache))
+      {
+        if (gtid_state->load(index_entry->list, index_entry->count))
+        {
+          errormsg= "Internal error (out of memory?) initialising slave "
+            "state while scanning binlog to find start position";
+          goto end;
+        }
+        my_b_seek(&cache, index_entry->offset);
+      }
     }
     else if (!found_gtid_list_event)
     {
@@ -2171,6 +2267,14 @@ static int init_binlog_sender(binlog_send_info *info,
     return 1;
   }
 
+  /*
+    Skip the start of the binlog file that the slave already has, using the
+    GTID index of the file. Not with START SLAVE UNTIL, which needs to see
+    all GTIDs of the file to track the binlog state.
+  */
+  if (info->using_gtid_state && !info->until_gtid_state)
+    *pos= gtid_index_start_pos(linfo->log_file_name, &info->gtid_state);
+
   // set current pos too
   linfo->pos= *pos;
 
@@ -2604,6 +2708,7 @@ static int send_events(binlog_send_info *info, IO_CACHE* log, LOG_INFO* linfo,
   ulong ev_offset;
 
   String *packet= info->packet;
+  Binlog_tail_cache *tail_cache= mysql_bin_log.get_tail_cache();
   linfo->pos= my_b_tell(log);
   info->last_pos= my_b_tell(log);
 
@@ -2618,15 +2723,30 @@ static int send_events(binlog_send_info *info, IO_CACHE* log, LOG_INFO* linfo,
       return 1;
 
     info->last_pos= linfo->pos;
-    error= Log_event::read_log_event(log, packet, info->fdev,
-                       opt_master_verify_checksum ? info->current_checksum_alg
-                                                  : BINLOG_CHECKSUM_ALG_OFF);
-    linfo->pos= my_b_tell(log);
-
-    if (error)
+    /*
+      Events that the dump thread would not have to verify or decrypt can
+      be taken from the shared tail of the binlog; the IO_CACHE is then
+      just moved past them.
+    */
+    if (!opt_master_verify_checksum && !info->fdev->crypto_data.scheme &&
+        !tail_cache->read_event(linfo->log_file_name, linfo->pos, end_pos,
+                                packet))
     {
-      set_read_error(info, error);
-      return 1;
+      linfo->pos+= packet->length() - ev_offset;
+      my_b_seek(log, linfo->pos);
+    }
+    else
+    {
+      error= Log_event::read_log_event(log, packet, info->fdev,
+                         opt_master_verify_checksum ? info->current_checksum_alg
+                                                    : BINLOG_CHECKSUM_ALG_OFF);
+      linfo->pos= my_b_tell(log);
+
+      if (error)
+      {
+        set_read_error(info, error);
+        return 1;
+      }
     }
 
     Log_event_type event_type=
@@ -3973,6 +4093,11 @@ bool mysql_show_binlog_events(THD* thd)
 
     thd->current_linfo= &linfo;
 
+    if (binary_log->flush_relay_log_buffer())
+    {
+      errmsg= "I/O error writing relay log";
+      goto err;
+    }
     if ((file=open_binlog(&log, linfo.log_file_name, &errmsg)) < 0)
       goto err;
 
@@ -1767,7 +1767,7 @@ int JOIN::optimize_stage2()
     conds=new (thd->mem_root) Item_int(thd, (longlong) 0, 1); // Always false
   }
 
-  /* Cache constant expressions in WHERE, HAVING, ON clauses. */
+  /* Cache constant expressions in WHERE, HAVING, ON clauses and results. */
   cache_const_exprs();
 
   if (setup_semijoin_loosescan(this))
@@ -6959,6 +6959,86 @@ static void choose_initial_table_order(JOIN *join)
 }
 
 
+/*
+  The cheapest partial plan found for a set of tables, see
+  prune_by_prefix_memo()
+*/
+
+struct Prefix_memo_entry
+{
+  /* The tables that are not in the partial plan, the hash key */
+  table_map remaining_tables;
+  double read_time;
+  double record_count;
+  /* FALSE if the first table of the plan is not join->sort_by_table */
+  bool sort_table_first;
+};
+
+
+/**
+  Check if a partial plan is dominated by an earlier one of the same tables
+
+  @details
+    The cost of completing a partial plan mostly depends on the set of
+    tables in it and on the number of rows it returns, not on the order
+    of the tables. A partial plan that costs at least as much as an earlier
+    one of the same tables, and returns at least as many rows, is not
+    expanded. Like optimizer_prune_level=1 this is a heuristic, as the
+    access methods picked for the tables can depend on their order.
+
+    Only called for partial plans that are expanded further, within one
+    step of greedy_search().
+
+  @param join             the join being optimized
+  @param remaining_tables tables that are not in the partial plan
+  @param read_time        cost of the partial plan
+  @param record_count     number of rows returned by the partial plan
+
+  @retval TRUE   the partial plan should not be expanded
+  @retval FALSE  the partial plan should be expanded
+*/
+
+static bool
+prune_by_prefix_memo(JOIN *join, table_map remaining_tables,
+                     double read_time, double record_count)
+{
+  Prefix_memo_entry *entry;
+  /* A plan not starting with sort_by_table may need a temporary table */
+  bool sort_table_first= !join->sort_by_table ||
+    join->positions[join->const_tables].table->table == join->sort_by_table;
+
+  if ((entry= (Prefix_memo_entry*) my_hash_search(join->prefix_memo,
+                                                  (uchar*) &remaining_tables,
+                                                  sizeof(remaining_tables))))
+  {
+    if (entry->read_time <= read_time &&
+        entry->record_count <= record_count &&
+        (entry->sort_table_first || !sort_table_first))
+      return TRUE;
+    if (read_time <= entry->read_time &&
+        record_count <= entry->record_count &&
+        (sort_table_first || !entry->sort_table_first))
+    {
+      entry->read_time= read_time;
+      entry->record_count= record_count;
+      entry->sort_table_first= sort_table_first;
+    }
+    return FALSE;
+  }
+
+  if (!(entry= (Prefix_memo_entry*) my_malloc(sizeof(*entry),
+                                              MYF(MY_THREAD_SPECIFIC))))
+    return FALSE;
+  entry->remaining_tables= remaining_tables;
+  entry->read_time= read_time;
+  entry->record_count= record_count;
+  entry->sort_table_first= sort_table_first;
+  if (my_hash_insert(join->prefix_memo, (uchar*) entry))
+    my_free(entry);
+  return FALSE;
+}
+
+
 /**
   Selects and invokes a search strategy for an optimal query plan.
 
@@ -7034,12 +7114,38 @@ choose_plan(JOIN *join, table_map join_tables)
   }
   else
   {
+    uint memo_min_tables=
+      (uint) join->thd->variables.optimizer_prefix_memo_min_tables;
+    HASH prefix_memo;
+    bool error;
+
     DBUG_ASSERT(search_depth <= MAX_TABLES + 1);
     if (search_depth == 0)
       /* Automatically determine a reasonable value for 'search_depth' */
       search_depth= determine_search_depth(join);
-    if (greedy_search(join, join_tables, search_depth, prune_level,
-                      use_cond_selectivity))
+
+    /*
+      The memo assumes that the cost of extending a partial plan does not
+      depend on the order of its tables, which is not true for semi-join
+      strategies.
+    */
+    if (prune_level == 1 && memo_min_tables &&
+        join->table_count - join->const_tables >= memo_min_tables &&
+        !join->emb_sjm_nest && !join->select_lex->sj_nests.elements &&
+        !my_hash_init(&prefix_memo, &my_charset_bin, 256,
+                      offsetof(Prefix_memo_entry, remaining_tables),
+                      sizeof(table_map), NULL, (my_hash_free_key) my_free,
+                      HASH_THREAD_SPECIFIC))
+      join->prefix_memo= &prefix_memo;
+
+    error= greedy_search(join, join_tables, search_depth, prune_level,
+                         use_cond_selectivity);
+    if (join->prefix_memo)
+    {
+      my_hash_free(join->prefix_memo);
+      join->prefix_memo= NULL;
+    }
+    if (error)
       DBUG_RETURN(TRUE);
   }
 
@@ -7050,7 +7156,10 @@ choose_plan(JOIN *join, table_map join_tables)
     TODO: calculate a correct cost for a query with subqueries and UNIONs.
   */
   if (join->thd->lex->is_single_level_stmt())
+  {
     join->thd->status_var.last_query_cost= join->best_read;
+    join->thd->status_var.last_query_partial_plans= join->partial_plans;
+  }
   DBUG_RETURN(FALSE);
 }
 
@@ -7460,6 +7569,9 @@ greedy_search(JOIN      *join,
   do {
     /* Find the extension of the current QEP with the lowest cost */
     join->best_read= DBL_MAX;
+    /* The plans remembered in the previous step have a different prefix */
+    if (join->prefix_memo)
+      my_hash_reset(join->prefix_memo);
     if (best_extension_by_limited_search(join, remaining_tables, idx, record_count,
                                          read_time, search_depth, prune_level,
                                          use_cond_selectivity))
@@ -8227,6 +8339,7 @@ best_extension_by_limited_search(JOIN      *join,
       POSITION loose_scan_pos;
       best_access_path(join, s, remaining_tables, idx, disable_jbuf,
                        record_count, join->positions + idx, &loose_scan_pos);
+      join->partial_plans++;
 
       /* Compute the cost of extending the plan with 's', avoid overflow */
       if (position->records_read < DBL_MAX / record_count)
@@ -8296,6 +8409,19 @@ best_extension_by_limited_search(JOIN      *join,
                                         pushdown_cond_selectivity;
       if ( (search_depth > 1) && (remaining_tables & ~real_table_bit) & allowed_tables )
       { /* Recursively expand the current partial plan */
+        if (join->prefix_memo &&
+            prune_by_prefix_memo(join, remaining_tables & ~real_table_bit,
+                                 current_read_time, partial_join_cardinality))
+        {
+          DBUG_EXECUTE("opt", print_plan(join, idx+1,
+                                         current_record_count,
+                                         read_time,
+                                         current_read_time,
+                                         "pruned_by_memo"););
+          restore_prev_nj_state(s);
+          restore_prev_sj_state(remaining_tables, s, idx);
+          continue;
+        }
         swap_variables(JOIN_TAB*, join->best_ref[idx], *pos);
         if (best_extension_by_limited_search(join,
                                              remaining_tables & ~real_table_bit,
@@ -26065,7 +26191,8 @@ JOIN::reoptimize(Item *added_where, table_map join_tables,
 
 
 /**
-  Cache constant expressions in WHERE, HAVING, ON conditions.
+  Cache constant expressions in WHERE, HAVING, ON conditions and in the
+  expressions computed for each result row.
 */
 
 void JOIN::cache_const_exprs()
@@ -26097,6 +26224,28 @@ void JOIN::cache_const_exprs()
                                  (uchar *)&cache_flag);
     }
   }
+
+  /*
+    Cache constant subexpressions of the expressions evaluated for each
+    row of the result. The expressions themselves are left in place, as
+    they are referenced from ref_pointer_array. EXPLAIN is left alone so
+    that the printed select list stays the one of the query.
+  */
+  if (thd->lex->describe)
+    return;
+  List_iterator<Item> it(all_fields);
+  Item *item;
+  while ((item= it++))
+  {
+    item= item->real_item();
+    if ((item->type() != Item::FUNC_ITEM && item->type() != Item::COND_ITEM) ||
+        item->const_item() || item->with_sum_func || item->with_window_func)
+      continue;
+    cache_flag= FALSE;
+    item->compile(thd, &Item::cache_const_expr_analyzer,
+                  (uchar **)&analyzer_arg,
+                  &Item::cache_const_expr_transformer, (uchar *)&cache_flag);
+  }
 }
 
  
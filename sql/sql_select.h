@@ -1226,6 +1226,14 @@ class JOIN :public Sql_alloc
     join->positions[i].records_read of a JOIN.
   */
   double   join_record_count;
+  /* Number of partial plans considered by the join order search */
+  ulonglong partial_plans;
+  /*
+    The cheapest partial plan found for each set of remaining tables in the
+    current step of greedy_search(), see prune_by_prefix_memo(). NULL when
+    not used.
+  */
+  HASH *prefix_memo;
   List<Item> *fields;
   List<Cached_item> group_fields, group_fields_cache;
   THD	   *thd;
@@ -1509,6 +1517,8 @@ class JOIN :public Sql_alloc
     in_to_exists_where= NULL;
     in_to_exists_having= NULL;
     emb_sjm_nest= NULL;
+    partial_plans= 0;
+    prefix_memo= NULL;
     sjm_lookup_tables= 0;
     sjm_scan_tables= 0;
   }
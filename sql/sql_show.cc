@@ -3603,34 +3603,54 @@ static bool show_status_array(THD *thd, const char *wild,
 /*
   collect status for all running threads
   Return number of threads used
+
+  NOTES
+    Ended threads are in global_status_var. Connection and replication
+    threads fold their status into status_shards at the end of each command
+    or event (see THD::fold_status_to_global()), so only what they are
+    executing now is left out. The current thread's command is included so
+    that SHOW GLOBAL STATUS counts itself. Threads that never fold, like
+    wsrep appliers and other background threads, are summed as before.
 */
 
 uint calc_sum_of_all_status(STATUS_VAR *to)
 {
   uint count= 0;
+  THD *thd= current_thd;
   DBUG_ENTER("calc_sum_of_all_status");
 
+  /* Get global values as base */
+  *to= global_status_var;
+  to->local_memory_used= 0;
+
+  /* Add status folded by running threads */
+  for (uint i= 0; i < STATUS_SHARDS; i++)
+  {
+    mysql_mutex_lock(&status_shards[i].lock);
+    add_to_status(to, &status_shards[i].status);
+    to->local_memory_used+= status_shards[i].status.local_memory_used;
+    mysql_mutex_unlock(&status_shards[i].lock);
+  }
+
   /* Ensure that thread id not killed during loop */
   mysql_mutex_lock(&LOCK_thread_count); // For unlink from list
 
   I_List_iterator<THD> it(threads);
   THD *tmp;
 
-  /* Get global values as base */
-  *to= global_status_var;
-  to->local_memory_used= 0;
-
-  /* Add to this status from existing threads */
+  /* Add to this status from existing threads that have not folded it */
   while ((tmp= it++))
   {
     count++;
-    if (!tmp->status_in_global)
+    if (!tmp->status_in_global && (!tmp->status_folded || tmp == thd))
     {
-      add_to_status(to, &tmp->status_var);
-      to->local_memory_used+= tmp->status_var.local_memory_used;
+      add_diff_to_status(to, &tmp->status_var, &tmp->status_var_folded);
+      to->global_memory_used+= tmp->status_var.global_memory_used;
+      to->local_memory_used+= (tmp->status_var.local_memory_used -
+                               tmp->status_var_folded.local_memory_used);
     }
   }
-  
+
   mysql_mutex_unlock(&LOCK_thread_count);
   DBUG_RETURN(count);
 }
@@ -4626,6 +4646,265 @@ try_acquire_high_prio_shared_mdl_lock(THD *thd, TABLE_LIST *table,
 }
 
 
+/*
+  Set the columns of a row of INFORMATION_SCHEMA.TABLES that are not
+  NULL for a base table
+*/
+
+static void set_schema_tables_record_notnull(TABLE *table)
+{
+  for (int i= 4; i < 20; i++)
+  {
+    if (i == 7 || (i > 12 && i < 17) || i == 18)
+      continue;
+    table->field[i]->set_notnull();
+  }
+}
+
+
+/*
+  Cache of the columns of INFORMATION_SCHEMA.TABLES that are read from the
+  .frm file of a base table (see --information-schema-tables-cache-size).
+
+  A query that only needs such columns fills the rows of cached tables
+  without taking a metadata lock and without reading the table definition
+  into the table definition cache. Entries are added when a definition is
+  read for such a query, and removed by tdc_remove_table(), which all DDL
+  statements call for the tables they change. FLUSH TABLES empties the
+  cache.
+*/
+
+ulong is_tables_cache_size;
+
+/*
+  The cached columns: TABLE_TYPE, ENGINE, VERSION, TABLE_COLLATION and
+  TABLE_COMMENT
+*/
+static const uint is_tables_cache_fields[]= { 3, 4, 5, 17, 20 };
+#define IS_TABLES_CACHE_FIELDS array_elements(is_tables_cache_fields)
+
+struct IS_tables_cache_entry
+{
+  IS_tables_cache_entry *next, **prev;  /* Eviction order, oldest first */
+  uchar *key;                           /* "db\0table_name\0" */
+  uint key_length;
+  LEX_CSTRING value[IS_TABLES_CACHE_FIELDS];
+};
+
+static HASH is_tables_cache;
+static I_P_List <IS_tables_cache_entry,
+                 I_P_List_adapter<IS_tables_cache_entry,
+                                  &IS_tables_cache_entry::next,
+                                  &IS_tables_cache_entry::prev>,
+                 I_P_List_null_counter,
+                 I_P_List_fast_push_back<IS_tables_cache_entry> >
+  is_tables_cache_list;
+static mysql_mutex_t LOCK_is_tables_cache;
+static bool is_tables_cache_inited;
+
+
+static uchar *
+is_tables_cache_get_key(const uchar *data, size_t *len_ret,
+                        my_bool __attribute__((unused)))
+{
+  IS_tables_cache_entry *entry= (IS_tables_cache_entry *) data;
+  *len_ret= entry->key_length;
+  return entry->key;
+}
+
+
+void is_tables_cache_init()
+{
+  mysql_mutex_init(key_LOCK_is_tables_cache, &LOCK_is_tables_cache,
+                   MY_MUTEX_INIT_FAST);
+  my_hash_init(&is_tables_cache, &my_charset_bin, 64, 0, 0,
+               is_tables_cache_get_key, my_free, 0);
+  is_tables_cache_inited= true;
+}
+
+
+void is_tables_cache_free()
+{
+  if (!is_tables_cache_inited)
+    return;
+  is_tables_cache_inited= false;
+  is_tables_cache_list.empty();
+  my_hash_free(&is_tables_cache);
+  mysql_mutex_destroy(&LOCK_is_tables_cache);
+}
+
+
+/* Build the key of a table, normalized the same way as for metadata locks */
+
+static uint is_tables_cache_key(char *key, const char *db,
+                                const char *table_name)
+{
+  char *end= strmake(key, db, NAME_LEN) + 1;
+  end= strmake(end, table_name, NAME_LEN) + 1;
+  if (lower_case_table_names)
+  {
+    my_casedn_str(files_charset_info, key);
+    my_casedn_str(files_charset_info, key + strlen(key) + 1);
+  }
+  return (uint) (end - key);
+}
+
+
+static void is_tables_cache_evict(uint size)
+{
+  mysql_mutex_assert_owner(&LOCK_is_tables_cache);
+  while (is_tables_cache.records > size)
+  {
+    IS_tables_cache_entry *entry= is_tables_cache_list.pop_front();
+    my_hash_delete(&is_tables_cache, (uchar *) entry);
+  }
+}
+
+
+/* Shrink the cache after --information-schema-tables-cache-size changed */
+
+void is_tables_cache_resize()
+{
+  if (!is_tables_cache_inited)
+    return;
+  mysql_mutex_lock(&LOCK_is_tables_cache);
+  is_tables_cache_evict(is_tables_cache_size);
+  mysql_mutex_unlock(&LOCK_is_tables_cache);
+}
+
+
+void is_tables_cache_remove(const char *db, const char *table_name)
+{
+  char key[MAX_DBKEY_LENGTH];
+  uint key_length;
+  IS_tables_cache_entry *entry;
+
+  /*
+    Entries of a table are only added while a metadata lock on it is held,
+    so none can be added concurrently for a table that is being changed.
+  */
+  if (!is_tables_cache_inited || !is_tables_cache.records)
+    return;
+  key_length= is_tables_cache_key(key, db, table_name);
+  mysql_mutex_lock(&LOCK_is_tables_cache);
+  if ((entry= (IS_tables_cache_entry *)
+       my_hash_search(&is_tables_cache, (uchar *) key, key_length)))
+  {
+    is_tables_cache_list.remove(entry);
+    my_hash_delete(&is_tables_cache, (uchar *) entry);
+  }
+  mysql_mutex_unlock(&LOCK_is_tables_cache);
+}
+
+
+void is_tables_cache_flush()
+{
+  if (!is_tables_cache_inited)
+    return;
+  mysql_mutex_lock(&LOCK_is_tables_cache);
+  is_tables_cache_list.empty();
+  my_hash_reset(&is_tables_cache);
+  mysql_mutex_unlock(&LOCK_is_tables_cache);
+}
+
+
+/* Remember the cached columns of a row of INFORMATION_SCHEMA.TABLES */
+
+static void is_tables_cache_add(TABLE *table, const LEX_CSTRING *db_name,
+                                const LEX_CSTRING *table_name)
+{
+  char key[MAX_DBKEY_LENGTH];
+  uint key_length;
+  char buff[MAX_FIELD_WIDTH];
+  String value[IS_TABLES_CACHE_FIELDS];
+  size_t length= 0;
+  IS_tables_cache_entry *entry;
+  char *pos;
+
+  key_length= is_tables_cache_key(key, db_name->str, table_name->str);
+  for (uint i= 0; i < IS_TABLES_CACHE_FIELDS; i++)
+  {
+    String tmp(buff, sizeof(buff), system_charset_info);
+    table->field[is_tables_cache_fields[i]]->val_str(&tmp);
+    if (value[i].copy(tmp))
+      return;
+    length+= value[i].length();
+  }
+
+  if (!(entry= (IS_tables_cache_entry *)
+        my_malloc(sizeof(*entry) + key_length + length, MYF(0))))
+    return;
+  entry->key= (uchar *) (entry + 1);
+  entry->key_length= key_length;
+  memcpy(entry->key, key, key_length);
+  pos= (char *) entry->key + key_length;
+  for (uint i= 0; i < IS_TABLES_CACHE_FIELDS; i++)
+  {
+    entry->value[i].str= pos;
+    entry->value[i].length= value[i].length();
+    memcpy(pos, value[i].ptr(), value[i].length());
+    pos+= value[i].length();
+  }
+
+  mysql_mutex_lock(&LOCK_is_tables_cache);
+  if (my_hash_search(&is_tables_cache, entry->key, key_length) ||
+      my_hash_insert(&is_tables_cache, (uchar *) entry))
+  {
+    /* Added by a concurrent query meanwhile */
+    mysql_mutex_unlock(&LOCK_is_tables_cache);
+    my_free(entry);
+    return;
+  }
+  is_tables_cache_list.push_back(entry);
+  is_tables_cache_evict(is_tables_cache_size);
+  mysql_mutex_unlock(&LOCK_is_tables_cache);
+}
+
+
+/**
+  @brief          Fill a row of INFORMATION_SCHEMA.TABLES from the cache
+
+  @return         Operation status
+    @retval       0           The table is not cached
+    @retval       1           The row was stored
+    @retval       -1          Error storing the row
+*/
+
+static int fill_schema_tables_from_cache(THD *thd, TABLE *table,
+                                         const LEX_CSTRING *db_name,
+                                         const LEX_CSTRING *table_name)
+{
+  char key[MAX_DBKEY_LENGTH];
+  uint key_length;
+  IS_tables_cache_entry *entry;
+  CHARSET_INFO *cs= system_charset_info;
+
+  if (!is_tables_cache_size)
+    return 0;
+  key_length= is_tables_cache_key(key, db_name->str, table_name->str);
+
+  mysql_mutex_lock(&LOCK_is_tables_cache);
+  if (!(entry= (IS_tables_cache_entry *)
+        my_hash_search(&is_tables_cache, (uchar *) key, key_length)))
+  {
+    mysql_mutex_unlock(&LOCK_is_tables_cache);
+    return 0;
+  }
+  restore_record(table, s->default_values);
+  table->field[0]->store(STRING_WITH_LEN("def"), cs);
+  table->field[1]->store(db_name->str, db_name->length, cs);
+  table->field[2]->store(table_name->str, table_name->length, cs);
+  set_schema_tables_record_notnull(table);
+  for (uint i= 0; i < IS_TABLES_CACHE_FIELDS; i++)
+    table->field[is_tables_cache_fields[i]]->store(entry->value[i].str,
+                                                   entry->value[i].length,
+                                                   cs);
+  mysql_mutex_unlock(&LOCK_is_tables_cache);
+
+  return schema_table_store_record(thd, table) ? -1 : 1;
+}
+
+
 /**
   @brief          Fill I_S table with data from FRM file only
 
@@ -5035,6 +5314,15 @@ int get_all_tables(THD *thd, TABLE_LIST *tables, COND *cond)
             if (!(table_open_method & ~OPEN_FRM_ONLY) &&
                 db_name != &INFORMATION_SCHEMA_NAME)
             {
+              if (schema_table_idx == SCH_TABLES)
+              {
+                int res= fill_schema_tables_from_cache(thd, table, db_name,
+                                                       table_name);
+                if (res < 0)
+                  goto err;
+                if (res)
+                  continue;
+              }
               if (!fill_schema_table_from_frm(thd, table, schema_table,
                                               db_name, table_name,
                                               &open_tables_state_backup,
@@ -5208,12 +5496,7 @@ static int get_schema_tables_record(THD *thd, TABLE_LIST *tables,
     else
       table->field[3]->store(STRING_WITH_LEN("BASE TABLE"), cs);
 
-    for (int i= 4; i < 20; i++)
-    {
-      if (i == 7 || (i > 12 && i < 17) || i == 18)
-        continue;
-      table->field[i]->set_notnull();
-    }
+    set_schema_tables_record_notnull(table);
 
     /* Collect table info from the table share */
 
@@ -5330,6 +5613,9 @@ static int get_schema_tables_record(THD *thd, TABLE_LIST *tables,
     if (share->comment.str)
       table->field[20]->store(share->comment.str, share->comment.length, cs);
 
+    if (!file && is_tables_cache_size && !share->tmp_table)
+      is_tables_cache_add(table, db_name, table_name);
+
     /* Collect table info from the storage engine  */
 
     if(file)
@@ -236,6 +236,14 @@ class IS_table_read_plan : public Sql_alloc
 
 bool optimize_schema_tables_reads(JOIN *join);
 
+/* Cache of the .frm columns of INFORMATION_SCHEMA.TABLES */
+extern ulong is_tables_cache_size;
+void is_tables_cache_init();
+void is_tables_cache_free();
+void is_tables_cache_resize();
+void is_tables_cache_remove(const char *db, const char *table_name);
+void is_tables_cache_flush();
+
 /* Handle the ignored database directories list for SHOW/I_S. */
 bool ignore_db_dirs_init();
 void ignore_db_dirs_free();
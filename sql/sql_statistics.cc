@@ -32,6 +32,12 @@
 #include "my_atomic.h"
 #include "sql_show.h"
 
+/*
+  The number of rows below which ANALYZE reads the whole table when
+  analyze_sample_percentage is set to 0
+*/
+#define MIN_THRESHOLD_FOR_SAMPLING 50000
+
 /*
   The system variable 'use_stat_tables' can take one of the
   following values:
@@ -330,7 +336,7 @@ class Column_statistics_collected :public Column_statistics
 
   inline void init(THD *thd, Field * table_field);
   inline bool add(ha_rows rowno);
-  inline void finish(ha_rows rows); 
+  inline void finish(ha_rows rows, double sample_fraction);
   inline void cleanup();
 };
 
@@ -1546,6 +1552,7 @@ class Histogram_builder
   uint curr_bucket;        /* number of the current bucket to be built     */
   ulonglong count;         /* number of values retrieved                   */
   ulonglong count_distinct;    /* number of distinct values retrieved      */
+  ulonglong count_singletons;  /* number of values occurring only once     */
 
 public: 
   Histogram_builder(Field *col, uint col_len, ha_rows rows)
@@ -1560,13 +1567,17 @@ class Histogram_builder
     curr_bucket= 0;
     count= 0;
     count_distinct= 0;    
+    count_singletons= 0;
   }
 
   ulonglong get_count_distinct() { return count_distinct; }
+  ulonglong get_count_singletons() { return count_singletons; }
 
   int next(void *elem, element_count elem_cnt)
   {
     count_distinct++;
+    if (elem_cnt == 1)
+      count_singletons++;
     count+= elem_cnt;
     if (curr_bucket == hist_width)
       return 0;
@@ -1596,6 +1607,15 @@ int histogram_build_walk(void *elem, element_count elem_cnt, void *arg)
   return hist_builder->next(elem, elem_cnt);
 }
 
+
+int count_distinct_singleton_walk(void *elem, element_count count, void *arg)
+{
+  ((ulonglong*)arg)[0]++;
+  if (count == 1)
+    ((ulonglong*)arg)[1]++;
+  return 0;
+}
+
 C_MODE_END
 
 
@@ -1683,14 +1703,29 @@ class Count_distinct_field: public Sql_alloc
     return count;
   }
 
+  /*
+    @brief
+    Calculate the number of elements accumulated in the container of 'tree'
+    and the number of those of them that were added only once
+  */
+  ulonglong get_value_and_singletons(ulonglong *singletons)
+  {
+    ulonglong counts[2]= {0, 0};
+    tree->walk(table_field->table, count_distinct_singleton_walk,
+               (void*) counts);
+    *singletons= counts[1];
+    return counts[0];
+  }
+
   /*
     @brief
     Build the histogram for the elements accumulated in the container of 'tree'
   */
-  ulonglong get_value_with_histogram(ha_rows rows)
+  ulonglong get_value_with_histogram(ha_rows rows, ulonglong *singletons)
   {
     Histogram_builder hist_builder(table_field, tree_key_length, rows);
     tree->walk(table_field->table,  histogram_build_walk, (void *) &hist_builder);
+    *singletons= hist_builder.get_count_singletons();
     return hist_builder.get_count_distinct();
   }
 
@@ -2505,16 +2540,50 @@ bool Column_statistics_collected::add(ha_rows rowno)
 }
 
 
+/**
+  @brief
+  Estimate the number of distinct values in a column from a sample
+
+  @param
+  n                The number of not NULL values in the sample
+  @param
+  d                The number of distinct values in the sample
+  @param
+  f1               The number of values that occur in the sample only once
+  @param
+  sample_fraction  The fraction of the table rows in the sample
+
+  @details
+  The function uses the Duj1 estimator by Haas and Stokes:
+    D= n*d / (n - f1 + f1*n/N),
+  where N= n/sample_fraction is the estimated number of not NULL values
+  in the column.
+*/
+
+static
+double estimate_distincts(ulonglong n, ulonglong d, ulonglong f1,
+                          double sample_fraction)
+{
+  double total= (double) n / sample_fraction;
+  double denom= (double) n - (double) f1 * (1 - sample_fraction);
+  if (denom <= 0)
+    return (double) d;
+  return MY_MIN((double) n * d / denom, total);
+}
+
+
 /**
   @brief
   Get the results of aggregation when collecting the statistics on a column
   
   @param
-  rows          The total number of rows in the table 
+  rows             The number of rows the statistics was collected on
+  @param
+  sample_fraction  The fraction of the table rows these rows make up
 */
 
 inline
-void Column_statistics_collected::finish(ha_rows rows)
+void Column_statistics_collected::finish(ha_rows rows, double sample_fraction)
 {
   double val;
 
@@ -2533,14 +2602,23 @@ void Column_statistics_collected::finish(ha_rows rows)
   if (count_distinct)
   {
     ulonglong distincts;
+    ulonglong singletons= 0;
     uint hist_size= count_distinct->get_hist_size();
-    if (hist_size == 0)
-      distincts= count_distinct->get_value();
+    if (hist_size)
+      distincts= count_distinct->get_value_with_histogram(rows - nulls,
+                                                          &singletons);
+    else if (sample_fraction < 1)
+      distincts= count_distinct->get_value_and_singletons(&singletons);
     else
-      distincts= count_distinct->get_value_with_histogram(rows - nulls);
+      distincts= count_distinct->get_value();
     if (distincts)
     {
-      val= (double) (rows - nulls) / distincts;
+      if (sample_fraction < 1)
+        val= (rows - nulls) / sample_fraction /
+             estimate_distincts(rows - nulls, distincts, singletons,
+                                sample_fraction);
+      else
+        val= (double) (rows - nulls) / distincts;
       set_avg_frequency(val); 
       set_not_null(COLUMN_STAT_AVG_FREQUENCY);
     }
@@ -2699,6 +2777,11 @@ int collect_statistics_for_index(THD *thd, TABLE *table, uint index)
   (or its derivation). Currently this class cannot count the number of
   distinct values for blob columns. So the value of 'avg_frequency' for
   blob columns is always null.
+  When analyze_sample_percentage is below 100 only a random sample of the
+  scanned rows is passed to the column collectors. The scan itself still
+  reads every row, as the handler interface has no way to skip pages, so
+  sampling saves the CPU and memory spent on aggregation, not the I/O.
+  The cardinality of the table is the exact number of scanned rows.
   After the full table scan the function calls collect_statistics_for_index
   for each table index. The latter performs full index scan for each index.
 
@@ -2721,11 +2804,27 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
   int rc;
   Field **field_ptr;
   Field *table_field;
-  ha_rows rows= 0;
+  ha_rows rows= 0, rows_read= 0;
   handler *file=table->file;
+  double sample_fraction= thd->variables.sample_percentage / 100;
 
   DBUG_ENTER("collect_statistics_for_table");
 
+  if (sample_fraction == 0)
+  {
+    /*
+      Sample MIN_THRESHOLD_FOR_SAMPLING rows and a share of the rest
+      that is growing logarithmically with the size of the table.
+    */
+    double records= (double) file->stats.records;
+    if (records <= MIN_THRESHOLD_FOR_SAMPLING)
+      sample_fraction= 1;
+    else
+      sample_fraction=
+        MY_MIN(MIN_THRESHOLD_FOR_SAMPLING *
+               (1 + log(records / MIN_THRESHOLD_FOR_SAMPLING)) / records, 1);
+  }
+
   table->collected_stats->cardinality_is_null= TRUE;
   table->collected_stats->cardinality= 0;
 
@@ -2756,6 +2855,12 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
         break;
       }
 
+      rows_read++;
+
+      /* The row has been read already, only its aggregation is skipped */
+      if (sample_fraction < 1 && my_rnd(&thd->rand) >= sample_fraction)
+        continue;
+
       for (field_ptr= table->field; *field_ptr; field_ptr++)
       {
         table_field= *field_ptr;
@@ -2780,7 +2885,7 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
   if (!rc)
   {
     table->collected_stats->cardinality_is_null= FALSE;
-    table->collected_stats->cardinality= rows;
+    table->collected_stats->cardinality= rows_read;
   }
 
   bitmap_clear_all(table->write_set);
@@ -2791,7 +2896,7 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
       continue;
     bitmap_set_bit(table->write_set, table_field->field_index); 
     if (!rc)
-      table_field->collected_stats->finish(rows);
+      table_field->collected_stats->finish(rows, sample_fraction);
     else
       table_field->collected_stats->cleanup();
   }
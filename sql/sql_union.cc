@@ -1688,10 +1688,24 @@ bool st_select_lex_unit::exec_recursive()
 
   while ((rec_table= li++))
   {
-    saved_error=
-      incr_table->insert_all_rows_into_tmp_table(thd, rec_table,
-                                                 tmp_table_param,
-                                                 !is_unrestricted);
+    /*
+      When the only recursive reference reads just the rows of the last
+      iteration, the rows of the previous one are not needed any more:
+      hand the new rows over to it instead of copying them.
+    */
+    bool exchanged= false;
+    if (!is_unrestricted && !rec_table->no_rows &&
+        with_element->rec_result->rec_tables.elements == 1)
+    {
+      incr_table->file->ha_index_or_rnd_end();
+      rec_table->file->ha_index_or_rnd_end();
+      exchanged= !incr_table->file->ha_exchange_rows(rec_table->file);
+    }
+    if (!exchanged)
+      saved_error=
+        incr_table->insert_all_rows_into_tmp_table(thd, rec_table,
+                                                   tmp_table_param,
+                                                   !is_unrestricted);
     if (!with_element->rec_result->first_rec_table_to_update)
       with_element->rec_result->first_rec_table_to_update= rec_table;
     if (with_element->level == 1 && rec_table->reginfo.join_tab)
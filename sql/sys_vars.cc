@@ -1242,6 +1242,14 @@ static Sys_var_uint Sys_log_bin_compress_min_len(
   GLOBAL_VAR(opt_bin_log_compress_min_len),
   CMD_LINE(OPT_ARG), VALID_RANGE(10, 1024), DEFAULT(256), BLOCK_SIZE(1));
 
+static Sys_var_mybool Sys_log_bin_compress_transactions(
+  "log_bin_compress_transactions",
+  "Compress all events of a transaction together, into one "
+  "Transaction_payload event. Slaves and mysqlbinlog must be of a version "
+  "that knows this event",
+  GLOBAL_VAR(opt_bin_log_compress_transactions), CMD_LINE(OPT_ARG),
+  DEFAULT(FALSE));
+
 static Sys_var_mybool Sys_trust_function_creators(
        "log_bin_trust_function_creators",
        "If set to FALSE (the default), then when --log-bin is used, creation "
@@ -1988,6 +1996,16 @@ static Sys_var_ulong Sys_slave_parallel_max_queued(
        VALID_RANGE(0,2147483647), DEFAULT(131072), BLOCK_SIZE(1));
 
 
+static Sys_var_mybool Sys_slave_parallel_prefetch(
+       "slave_parallel_prefetch",
+       "Look up the rows of row events queued for the parallel replication "
+       "threads by primary key in a separate thread, so that they are "
+       "already cached when the events are applied. Takes effect when the "
+       "slave SQL thread starts. Only used when --slave-parallel-threads > 0.",
+       GLOBAL_VAR(opt_slave_parallel_prefetch), CMD_LINE(OPT_ARG),
+       DEFAULT(FALSE));
+
+
 bool
 Sys_var_slave_parallel_mode::global_update(THD *thd, set_var *var)
 {
@@ -2155,6 +2173,29 @@ static Sys_var_ulong Sys_binlog_commit_wait_usec(
        VALID_RANGE(0, ULONG_MAX), DEFAULT(100000), BLOCK_SIZE(1));
 
 
+static const char *binlog_dependency_tracking_names[]=
+  {"GROUP_COMMIT", "WRITESET", NullS};
+static Sys_var_enum Sys_binlog_dependency_tracking(
+       "binlog_dependency_tracking",
+       "How the binlog tells a parallel slave which transactions it can "
+       "apply in parallel. GROUP_COMMIT: only transactions that group "
+       "committed together. WRITESET: also consecutive row-based "
+       "transactions that modified different primary and unique key values",
+       GLOBAL_VAR(opt_binlog_dependency_tracking), CMD_LINE(REQUIRED_ARG),
+       binlog_dependency_tracking_names,
+       DEFAULT(BINLOG_DEPENDENCY_GROUP_COMMIT));
+
+static Sys_var_ulong Sys_binlog_gtid_index_span(
+       "binlog_gtid_index_span",
+       "Minimum number of bytes written to a binlog file between two entries "
+       "of its GTID index (a .idx file next to it). The index lets slaves "
+       "connecting with GTID, and BINLOG_GTID_POS(), skip directly to a "
+       "point close to the wanted position instead of reading the binlog "
+       "file from the start. 0 disables the index",
+       GLOBAL_VAR(opt_binlog_gtid_index_span), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024*1024L*1024L), DEFAULT(65536), BLOCK_SIZE(1));
+
+
 static bool fix_max_join_size(sys_var *self, THD *thd, enum_var_type type)
 {
   SV *sv= type == OPT_GLOBAL ? &global_system_variables : &thd->variables;
@@ -2371,6 +2412,16 @@ static Sys_var_ulong Sys_open_files_limit(
        AUTO_SET READ_ONLY GLOBAL_VAR(open_files_limit), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, OS_FILE_LIMIT), DEFAULT(0), BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_optimizer_prefix_memo_min_tables(
+       "optimizer_prefix_memo_min_tables",
+       "For joins of at least this many tables, remember the cheapest "
+       "partial plan found for each set of tables, and do not expand "
+       "partial plans of the same tables that are more expensive and return "
+       "more rows. Only used with optimizer_prune_level=1 and without "
+       "semi-joins. 0 disables it",
+       SESSION_VAR(optimizer_prefix_memo_min_tables), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, MAX_TABLES), DEFAULT(12), BLOCK_SIZE(1));
+
 /// @todo change to enum
 static Sys_var_ulong Sys_optimizer_prune_level(
        "optimizer_prune_level",
@@ -2631,6 +2682,14 @@ static Sys_var_ulong Sys_range_alloc_block_size(
        VALID_RANGE(RANGE_ALLOC_BLOCK_SIZE, UINT_MAX),
        DEFAULT(RANGE_ALLOC_BLOCK_SIZE), BLOCK_SIZE(1024));
 
+static Sys_var_ulong Sys_range_estimate_cache_size(
+       "range_estimate_cache_size",
+       "Number of estimates of the rows in index ranges that each open "
+       "table keeps across statements. An estimate is used until a row of "
+       "the table is changed. 0 disables the cache",
+       GLOBAL_VAR(range_estimate_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 65536), DEFAULT(128), BLOCK_SIZE(1));
+
 static Sys_var_ulong Sys_multi_range_count(
        "multi_range_count", "Ignored. Use mrr_buffer_size instead",
        SESSION_VAR(multi_range_count), CMD_LINE(REQUIRED_ARG),
@@ -2663,6 +2722,15 @@ static Sys_var_ulong Sys_query_prealloc_size(
        BLOCK_SIZE(1024), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_thd_mem_root));
 
+static Sys_var_ulong Sys_parse_cache_size(
+       "parse_cache_size",
+       "Number of recently executed SELECT, INSERT, REPLACE, UPDATE and "
+       "DELETE statements for which a connection keeps the parse tree. A "
+       "statement sent again with the same text is executed without being "
+       "parsed again. 0 disables the cache",
+       SESSION_VAR(parse_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024), DEFAULT(0), BLOCK_SIZE(1));
+
 #ifdef HAVE_SMEM
 static Sys_var_mybool Sys_shared_memory(
        "shared_memory", "Enable the shared memory",
@@ -2979,6 +3047,14 @@ static Sys_var_enum Slave_run_triggers_for_rbr(
        slave_run_triggers_for_rbr_names,
        DEFAULT(SLAVE_RUN_TRIGGERS_FOR_RBR_NO));
 
+static Sys_var_mybool Sys_slave_rows_hash_scan(
+       "slave_rows_hash_scan",
+       "When applying an update or delete row event to a table without a "
+       "usable key, find all rows of the event in one table scan using a "
+       "hash of their before images, instead of doing a table scan per row",
+       GLOBAL_VAR(opt_slave_rows_hash_scan), CMD_LINE(OPT_ARG),
+       DEFAULT(TRUE));
+
 static const char *slave_type_conversions_name[]= {"ALL_LOSSY", "ALL_NON_LOSSY", 0};
 static Sys_var_set Slave_type_conversions(
        "slave_type_conversions",
@@ -3005,6 +3081,16 @@ static Sys_var_mybool Sys_master_verify_checksum(
        GLOBAL_VAR(opt_master_verify_checksum), CMD_LINE(OPT_ARG),
        DEFAULT(FALSE));
 
+static Sys_var_ulong Sys_binlog_tail_cache_size(
+       "binlog_tail_cache_size",
+       "Size of an in-memory copy of the end of the active binary log, "
+       "shared by all threads sending the binary log to slaves. A thread "
+       "sends events from it when they are still there, instead of reading "
+       "them from the binary log file. Not used when master_verify_checksum "
+       "or encrypt_binlog is ON. 0 disables the copy",
+       GLOBAL_VAR(opt_binlog_tail_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024*1024L*1024L), DEFAULT(0), BLOCK_SIZE(IO_SIZE));
+
 /* These names must match RPL_SKIP_XXX #defines in slave.h. */
 static const char *replicate_events_marked_for_skip_names[]= {
   "REPLICATE", "FILTER_ON_SLAVE", "FILTER_ON_MASTER", 0
@@ -3266,6 +3352,34 @@ static Sys_var_ulong Sys_table_def_size(
        VALID_RANGE(TABLE_DEF_CACHE_MIN, 512*1024),
        DEFAULT(TABLE_DEF_CACHE_DEFAULT), BLOCK_SIZE(1));
 
+static Sys_var_uint Sys_table_def_prewarm_threads(
+       "table_definition_cache_prewarm_threads",
+       "Number of threads that read table definitions into the table "
+       "definition cache after startup, until it is full. 0 disables "
+       "pre-warming",
+       READ_ONLY GLOBAL_VAR(tdc_prewarm_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 64), DEFAULT(0), BLOCK_SIZE(1));
+
+
+static bool fix_is_tables_cache_size(sys_var *, THD *, enum_var_type)
+{
+  mysql_mutex_unlock(&LOCK_global_system_variables);
+  is_tables_cache_resize();
+  mysql_mutex_lock(&LOCK_global_system_variables);
+  return false;
+}
+
+static Sys_var_ulong Sys_is_tables_cache_size(
+       "information_schema_tables_cache_size",
+       "The number of tables whose INFORMATION_SCHEMA.TABLES columns read "
+       "from the table definition are kept in memory, so that queries "
+       "that only need those columns do not read the definitions again. "
+       "0 disables the cache",
+       GLOBAL_VAR(is_tables_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 16*1024*1024), DEFAULT(0), BLOCK_SIZE(1),
+       NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
+       ON_UPDATE(fix_is_tables_cache_size));
+
 
 static bool fix_table_open_cache(sys_var *, THD *, enum_var_type)
 {
@@ -4877,6 +4991,26 @@ static Sys_var_uint Sys_sync_relaylog_period(
        GLOBAL_VAR(sync_relaylog_period), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, UINT_MAX), DEFAULT(10000), BLOCK_SIZE(1));
 
+static Sys_var_mybool Sys_relay_log_in_memory(
+       "relay_log_in_memory",
+       "For slave connections with MASTER_USE_GTID other than no, write "
+       "relay logs to disk only when --relay-log-buffer-size bytes have been "
+       "received, and never sync them. The SQL thread reads the events from "
+       "memory. After a crash the relay logs are discarded and the events "
+       "are fetched again from the master, starting at @@gtid_slave_pos. "
+       "Takes effect when both slave threads of a connection start.",
+       GLOBAL_VAR(opt_relay_log_in_memory), CMD_LINE(OPT_ARG),
+       DEFAULT(FALSE));
+
+static Sys_var_ulong Sys_relay_log_buffer_size(
+       "relay_log_buffer_size",
+       "The size of the memory buffer of a relay log when "
+       "--relay-log-in-memory is used. Takes effect when the next relay log "
+       "file is opened.",
+       GLOBAL_VAR(opt_relay_log_buffer_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(IO_SIZE, 1024*1024L*1024L), DEFAULT(1024*1024L),
+       BLOCK_SIZE(IO_SIZE));
+
 static Sys_var_uint Sys_sync_relayloginfo_period(
        "sync_relay_log_info", "Synchronously flush relay log info "
        "to disk after every #th transaction. Use 0 to disable "
@@ -5547,6 +5681,16 @@ static Sys_var_ulong Sys_histogram_size(
        SESSION_VAR(histogram_size), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, 255), DEFAULT(0), BLOCK_SIZE(1));
 
+static Sys_var_double Sys_analyze_sample_percentage(
+       "analyze_sample_percentage",
+       "Percentage of rows from the table ANALYZE TABLE will sample "
+       "to collect engine-independent column statistics. "
+       "Set it to 0 to let the server decide what percentage "
+       "of rows to sample.",
+       SESSION_VAR(sample_percentage),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 100),
+       DEFAULT(100));
+
 extern const char *histogram_types[];
 static Sys_var_enum Sys_histogram_type(
        "histogram_type",
@@ -3442,6 +3442,7 @@ int closefrm(register TABLE *table)
   }
   delete table->file;
   table->file= 0;				/* For easier errorchecking */
+  free_range_estimates(table);
 #ifdef WITH_PARTITION_STORAGE_ENGINE
   if (table->part_info)
   {
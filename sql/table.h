@@ -55,6 +55,7 @@ class Virtual_column_info;
 class Table_triggers_list;
 class TMP_TABLE_PARAM;
 class SEQUENCE;
+struct Range_estimate;
 
 /*
   Used to identify NESTED_JOIN structures within a join (applicable only to
@@ -635,6 +636,12 @@ struct TABLE_SHARE
   ulong   reclength;			/* Recordlength */
   /* Stored record length. No generated-only virtual fields are included */
   ulong   stored_rec_length;            
+  /*
+    Rows changed through all TABLE instances of the share, added up at the
+    end of each statement. Invalidates the estimates in
+    TABLE::range_estimates.
+  */
+  int64   rows_changed_count;
 
   plugin_ref db_plugin;			/* storage engine plugin */
   inline handlerton *db_type() const	/* table_type for handler */
@@ -1142,6 +1149,13 @@ struct TABLE
   ha_rows	quick_rows[MAX_KEY];
   double 	quick_costs[MAX_KEY];
 
+  /*
+    records_in_range() estimates kept across statements, see
+    handler::ha_records_in_range(). Allocated on first use.
+  */
+  Range_estimate *range_estimates;
+  ulong range_estimates_size;
+
   /* 
     Bitmaps of key parts that =const for the duration of join execution. If
     we're in a subquery, then the constant may be different across subquery
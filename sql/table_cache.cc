@@ -50,6 +50,8 @@
 #include "lf.h"
 #include "table.h"
 #include "sql_base.h"
+#include "sql_show.h"                           // is_tables_cache_remove
+#include "sql_table.h"                 // filename_to_tablename
 
 
 /** Configuration. */
@@ -1098,6 +1100,7 @@ bool tdc_remove_table(THD *thd, enum_tdc_remove_table_type remove_type,
               thd->mdl_context.is_lock_owner(MDL_key::TABLE, db, table_name,
                                              MDL_EXCLUSIVE));
 
+  is_tables_cache_remove(db, table_name);
 
   mysql_mutex_lock(&LOCK_unused_shares);
   if (!(element= tdc_lock_share(thd, db, table_name)))
@@ -1322,3 +1325,225 @@ int tdc_iterate(THD *thd, my_hash_walk_action action, void *argument,
   }
   return res;
 }
+
+
+/**
+  Pre-warming of the table definition cache at startup.
+
+  With --table-definition-cache-prewarm-threads=N, a background thread lists
+  the .frm files of all databases after startup, and N threads read them
+  into the table definition cache until it is full, so that the first
+  queries after a restart do not have to parse their table definitions.
+  Tables are taken in the order of the directory listing. A table that is
+  locked by DDL is skipped, and nothing waits for a lock.
+*/
+
+uint tdc_prewarm_threads;
+
+struct Tdc_prewarm_table
+{
+  const char *db, *table_name;
+};
+
+/* Set up by the coordinator thread before the workers start */
+static Dynamic_array<Tdc_prewarm_table> *tdc_prewarm_tables;
+static int32 tdc_prewarm_next;
+static int32 tdc_prewarm_stop;
+static bool tdc_prewarm_started;
+static pthread_t tdc_prewarm_thread;
+
+#ifdef HAVE_PSI_INTERFACE
+static PSI_thread_key key_thread_tdc_prewarm;
+static PSI_thread_info all_tdc_prewarm_threads[]=
+{
+  { &key_thread_tdc_prewarm, "tdc_prewarm", 0 }
+};
+#endif
+
+
+static bool tdc_prewarm_done()
+{
+  return my_atomic_load32_explicit(&tdc_prewarm_stop,
+                                   MY_MEMORY_ORDER_RELAXED) ||
+         tdc_records() >= tdc_size;
+}
+
+
+static THD *tdc_prewarm_thd()
+{
+  THD *thd= new THD(next_thread_id());
+  thd->thread_stack= (char*) &thd;
+  thd->store_globals();
+  thd->system_thread= SYSTEM_THREAD_GENERIC;
+  thd->security_ctx->skip_grants();
+  return thd;
+}
+
+
+/* Read the definition of one table into the cache */
+
+static void tdc_prewarm_table(THD *thd, Tdc_prewarm_table *t)
+{
+  TABLE_LIST table_list;
+  TABLE_SHARE *share;
+
+  table_list.init_one_table(t->db, strlen(t->db), t->table_name,
+                            strlen(t->table_name), t->table_name, TL_READ);
+  table_list.mdl_request.init(MDL_key::TABLE, t->db, t->table_name,
+                              MDL_SHARED_HIGH_PRIO, MDL_EXPLICIT);
+  if (thd->mdl_context.try_acquire_lock(&table_list.mdl_request) ||
+      !table_list.mdl_request.ticket)
+  {
+    thd->clear_error();
+    return;
+  }
+  if ((share= tdc_acquire_share(thd, &table_list, GTS_TABLE | GTS_VIEW)))
+    tdc_release_share(share);
+  thd->clear_error();
+  thd->mdl_context.release_lock(table_list.mdl_request.ticket);
+}
+
+
+pthread_handler_t tdc_prewarm_worker(void *arg)
+{
+  my_thread_init();
+  THD *thd= tdc_prewarm_thd();
+  while (!tdc_prewarm_done())
+  {
+    int32 i= my_atomic_add32_explicit(&tdc_prewarm_next, 1,
+                                      MY_MEMORY_ORDER_RELAXED);
+    if ((size_t) i >= tdc_prewarm_tables->elements())
+      break;
+    tdc_prewarm_table(thd, &tdc_prewarm_tables->at(i));
+  }
+  delete thd;
+  my_thread_end();
+  pthread_exit(0);
+  return 0;
+}
+
+
+/* Add the .frm files of all databases to tdc_prewarm_tables */
+
+static void tdc_prewarm_list(MEM_ROOT *root)
+{
+  MY_DIR *dirp, *db_dirp;
+  char path[FN_REFLEN], name[NAME_LEN + 1];
+
+  if (!(dirp= my_dir(mysql_data_home, MYF(MY_WANT_STAT))))
+    return;
+  for (uint i= 0; i < dirp->number_of_files && !tdc_prewarm_done(); i++)
+  {
+    FILEINFO *file= dirp->dir_entry + i;
+    const char *db;
+
+    if (!MY_S_ISDIR(file->mystat->st_mode) || file->name[0] == '.' ||
+        is_prefix(file->name, tmp_file_prefix))
+      continue;
+    filename_to_tablename(file->name, name, sizeof(name));
+    if (db_name_is_in_ignore_db_dirs_list(name) ||
+        !(db= strdup_root(root, name)))
+      continue;
+    build_table_filename(path, sizeof(path) - 1, db, "", "", 0);
+    if (!(db_dirp= my_dir(path, MYF(0))))
+      continue;
+    for (uint j= 0; j < db_dirp->number_of_files; j++)
+    {
+      char *ext= fn_ext(db_dirp->dir_entry[j].name);
+      Tdc_prewarm_table t;
+
+      if (strcmp(ext, reg_ext) ||
+          is_prefix(db_dirp->dir_entry[j].name, tmp_file_prefix))
+        continue;
+      *ext= 0;
+      filename_to_tablename(db_dirp->dir_entry[j].name, name, sizeof(name));
+      t.db= db;
+      if (!(t.table_name= strdup_root(root, name)) ||
+          tdc_prewarm_tables->append(t))
+        break;
+    }
+    my_dirend(db_dirp);
+  }
+  my_dirend(dirp);
+}
+
+
+pthread_handler_t tdc_prewarm_coordinator(void *arg)
+{
+  MEM_ROOT root;
+  pthread_t *workers;
+  uint started= 0;
+  my_thread_init();
+  THD *thd= tdc_prewarm_thd();
+  Dynamic_array<Tdc_prewarm_table> tables(1024, 1024);
+
+  init_alloc_root(&root, 16384, 0, MYF(0));
+  tdc_prewarm_tables= &tables;
+  tdc_prewarm_list(&root);
+  sql_print_information("Reading up to %lu of %zu table definitions into "
+                        "the table definition cache", tdc_size,
+                        tables.elements());
+
+  if ((workers= (pthread_t*) my_malloc(tdc_prewarm_threads *
+                                       sizeof(pthread_t), MYF(0))))
+  {
+    for (; started < tdc_prewarm_threads; started++)
+      if (mysql_thread_create(key_thread_tdc_prewarm, &workers[started],
+                              NULL, tdc_prewarm_worker, NULL))
+        break;
+    for (uint i= 0; i < started; i++)
+      pthread_join(workers[i], NULL);
+    my_free(workers);
+  }
+  if (!started)
+  {
+    /* Could not start any worker, do the work here */
+    for (size_t i= 0; i < tables.elements() && !tdc_prewarm_done(); i++)
+      tdc_prewarm_table(thd, &tables.at(i));
+  }
+
+  sql_print_information("Table definition cache pre-warming done, %lu "
+                        "definitions cached", tdc_records());
+  tdc_prewarm_tables= NULL;
+  free_root(&root, MYF(0));
+  delete thd;
+  my_thread_end();
+  pthread_exit(0);
+  return 0;
+}
+
+
+/**
+  Start pre-warming the table definition cache in the background, if
+  --table-definition-cache-prewarm-threads is set.
+*/
+
+void tdc_start_prewarm(void)
+{
+  if (!tdc_prewarm_threads)
+    return;
+#ifdef HAVE_PSI_INTERFACE
+  mysql_thread_register("sql", all_tdc_prewarm_threads,
+                        array_elements(all_tdc_prewarm_threads));
+#endif
+  if (mysql_thread_create(key_thread_tdc_prewarm, &tdc_prewarm_thread, NULL,
+                          tdc_prewarm_coordinator, NULL))
+    sql_print_warning("Could not start the thread that pre-warms the table "
+                      "definition cache");
+  else
+    tdc_prewarm_started= true;
+}
+
+
+/**
+  Stop pre-warming and wait for its threads to end. Called at shutdown.
+*/
+
+void tdc_stop_prewarm(void)
+{
+  if (!tdc_prewarm_started)
+    return;
+  my_atomic_store32_explicit(&tdc_prewarm_stop, 1, MY_MEMORY_ORDER_RELAXED);
+  pthread_join(tdc_prewarm_thread, NULL);
+  tdc_prewarm_started= false;
+}
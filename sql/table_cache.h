@@ -69,6 +69,7 @@ enum enum_tdc_remove_table_type
 };
 
 extern ulong tdc_size;
+extern uint tdc_prewarm_threads;
 extern ulong tc_size;
 extern uint32 tc_instances;
 extern uint32 tc_active_instances;
@@ -78,6 +79,8 @@ extern void tdc_start_shutdown(void);
 extern void tdc_deinit(void);
 extern ulong tdc_records(void);
 extern void tdc_purge(bool all);
+extern void tdc_start_prewarm(void);
+extern void tdc_stop_prewarm(void);
 extern TDC_element *tdc_lock_share(THD *thd, const char *db,
                                    const char *table_name);
 extern void tdc_unlock_share(TDC_element *element);
@@ -421,6 +421,28 @@ int ha_heap::delete_all_rows()
 }
 
 
+/*
+  Hand the rows of this internal table over to another one and take its
+  rows in exchange. Only the HP_INFO of the two handlers is swapped, the
+  handler objects stay with their tables.
+*/
+
+int ha_heap::exchange_rows(handler *other)
+{
+  ha_heap *heap= (ha_heap*) other;
+  if (!internal_table || !heap->internal_table ||
+      file->s->keys || heap->file->s->keys ||
+      file->s->reclength != heap->file->s->reclength)
+    return HA_ERR_WRONG_COMMAND;
+  swap_variables(HP_INFO*, file, heap->file);
+  swap_variables(HP_SHARE*, internal_share, heap->internal_share);
+  records_changed= heap->records_changed= 0;
+  key_stat_version= file->s->key_stat_version;
+  heap->key_stat_version= heap->file->s->key_stat_version;
+  return 0;
+}
+
+
 int ha_heap::reset_auto_increment(ulonglong value)
 {
   file->s->auto_increment= value;
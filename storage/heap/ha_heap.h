@@ -97,6 +97,7 @@ class ha_heap: public handler
   int reset();
   int external_lock(THD *thd, int lock_type);
   int delete_all_rows(void);
+  int exchange_rows(handler *other);
   int reset_auto_increment(ulonglong value);
   int disable_indexes(uint mode);
   int enable_indexes(uint mode);
@@ -1101,19 +1101,41 @@ int ha_myisammrg::write_row(uchar * buf)
     if ((error= update_auto_increment()))
       DBUG_RETURN(error); /* purecov: inspected */
   }
-  DBUG_RETURN(myrg_write(file,buf));
+  int error= myrg_write(file,buf);
+  if (!error)
+    child_row_changed();
+  DBUG_RETURN(error);
 }
 
 int ha_myisammrg::update_row(const uchar * old_data, const uchar * new_data)
 {
   DBUG_ASSERT(this->file->children_attached);
-  return myrg_update(file,old_data,new_data);
+  int error= myrg_update(file,old_data,new_data);
+  if (!error)
+    child_row_changed();
+  return error;
 }
 
 int ha_myisammrg::delete_row(const uchar * buf)
 {
   DBUG_ASSERT(this->file->children_attached);
-  return myrg_delete(file,buf);
+  int error= myrg_delete(file,buf);
+  if (!error)
+    child_row_changed();
+  return error;
+}
+
+
+/*
+  The child changed a row without its own handler knowing. Invalidate the
+  range estimates that handler::ha_records_in_range() keeps for the child.
+*/
+
+void ha_myisammrg::child_row_changed()
+{
+  TABLE *child= (TABLE*) file->current_table->table->external_ref;
+  my_atomic_add64_explicit(&child->s->rows_changed_count, 1,
+                           MY_MEMORY_ORDER_RELAXED);
 }
 
 int ha_myisammrg::index_read_map(uchar * buf, const uchar * key,
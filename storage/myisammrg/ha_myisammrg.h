@@ -72,6 +72,7 @@ class ha_myisammrg: public handler
 {
   MYRG_INFO *file;
   my_bool is_cloned;                    /* This instance has been cloned */
+  void child_row_changed();
 
 public:
   MEM_ROOT      children_mem_root;      /* mem root for children list */
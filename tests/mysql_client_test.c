@@ -20035,6 +20035,121 @@ static void test_proxy_header()
   test_proxy_header_ignore();
 }
 
+
+/*
+  Execute an array of parameter sets of a prepared UPDATE with
+  COM_STMT_BULK_EXECUTE.
+*/
+
+static int bulk_update(MYSQL_STMT *stmt, int *a, int *b)
+{
+  MYSQL_BIND bind[2];
+  unsigned int array_size= 3;
+  int rc;
+
+  memset(bind, 0, sizeof(bind));
+  bind[0].buffer_type= MYSQL_TYPE_LONG;
+  bind[0].buffer= b;
+  bind[1].buffer_type= MYSQL_TYPE_LONG;
+  bind[1].buffer= a;
+
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, &array_size);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_bind_param(stmt, bind);
+  check_execute(stmt, rc);
+  return mysql_stmt_execute(stmt);
+}
+
+
+/*
+  In autocommit mode an array is committed or rolled back as a whole,
+  inside an explicit transaction each parameter set is a statement of
+  that transaction.
+*/
+
+static void test_bulk_trx()
+{
+  MYSQL_STMT *stmt;
+  MYSQL_BIND bind[2];
+  unsigned int array_size= 3;
+  int a[3]= {1, 2, 3};
+  int b_ok[3]= {11, 12, 13};
+  int b_dup[3]= {21, 22, 21};
+  int rc;
+  const char *query= "UPDATE t_bulk SET b= ? WHERE a = ?";
+
+  myheader("test_bulk_trx");
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t_bulk");
+  myquery(rc);
+  rc= mysql_query(mysql, "CREATE TABLE t_bulk (a INT PRIMARY KEY, b INT UNIQUE)"
+                         " ENGINE=InnoDB");
+  myquery(rc);
+  rc= mysql_query(mysql, "INSERT INTO t_bulk VALUES (1,1),(2,2),(3,3)");
+  myquery(rc);
+
+  stmt= mysql_simple_prepare(mysql, query);
+  check_stmt(stmt);
+
+  /* All parameter sets succeed, the array is committed */
+  rc= bulk_update(stmt, a, b_ok);
+  check_execute(stmt, rc);
+  rc= mysql_rollback(mysql);
+  myquery(rc);
+  verify_col_data("t_bulk", "SUM(b)", "36");
+
+  /* The last parameter set fails, the first ones are rolled back too */
+  rc= bulk_update(stmt, a, b_dup);
+  check_execute_r(stmt, rc);
+  DIE_UNLESS(mysql_stmt_errno(stmt) == ER_DUP_ENTRY);
+  verify_col_data("t_bulk", "SUM(b)", "36");
+
+  /*
+    Inside an explicit transaction only the failing parameter set is
+    rolled back, the transaction decides about the others.
+  */
+  rc= mysql_query(mysql, "BEGIN");
+  myquery(rc);
+  rc= bulk_update(stmt, a, b_dup);
+  check_execute_r(stmt, rc);
+  DIE_UNLESS(mysql_stmt_errno(stmt) == ER_DUP_ENTRY);
+  verify_col_data("t_bulk", "SUM(b)", "56");
+  rc= mysql_rollback(mysql);
+  myquery(rc);
+  verify_col_data("t_bulk", "SUM(b)", "36");
+
+  rc= mysql_query(mysql, "BEGIN");
+  myquery(rc);
+  rc= bulk_update(stmt, a, b_dup);
+  check_execute_r(stmt, rc);
+  rc= mysql_commit(mysql);
+  myquery(rc);
+  verify_col_data("t_bulk", "SUM(b)", "56");
+
+  mysql_stmt_close(stmt);
+
+  /* REPLACE is executed once per parameter set, in one transaction */
+  stmt= mysql_simple_prepare(mysql, "REPLACE INTO t_bulk VALUES (?,?)");
+  check_stmt(stmt);
+  memset(bind, 0, sizeof(bind));
+  bind[0].buffer_type= MYSQL_TYPE_LONG;
+  bind[0].buffer= a;
+  bind[1].buffer_type= MYSQL_TYPE_LONG;
+  bind[1].buffer= b_ok;
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, &array_size);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_bind_param(stmt, bind);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_execute(stmt);
+  check_execute(stmt, rc);
+  verify_col_data("t_bulk", "SUM(b)", "36");
+  verify_col_data("t_bulk", "COUNT(*)", "3");
+  mysql_stmt_close(stmt);
+
+  rc= mysql_query(mysql, "DROP TABLE t_bulk");
+  myquery(rc);
+}
+
 #endif
 
 static struct my_tests_st my_tests[]= {
@@ -20320,6 +20435,7 @@ static struct my_tests_st my_tests[]= {
   { "test_mdev14013_1", test_mdev14013_1 },
 #ifndef EMBEDDED_LIBRARY
   { "test_proxy_header", test_proxy_header},
+  { "test_bulk_trx", test_bulk_trx },
 #endif
   { 0, 0 }
 };